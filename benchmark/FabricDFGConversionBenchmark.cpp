@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2010-2017 Fabric Software Inc. All rights reserved.
+//
+
+// Micro-benchmark for the array conversion kernels used by the Canvas
+// plug <-> port conversions. Build it with 'scons conversionBenchmark'.
+// Usage: FabricDFGConversionBenchmark [numElements] [numIterations]
+
+#include "FabricDFGConversionKernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+
+static double s_sink = 0.0;
+
+static double elapsedMs(clock_t start)
+{
+  return 1000.0 * (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+}
+
+static void report(char const * label, double ms, size_t numElements, unsigned numIterations)
+{
+  double perIteration = ms / (double)numIterations;
+  printf("%-40s %10.3f ms/iter %10.2f Melem/s\n",
+    label, perIteration, (double)numElements / (perIteration * 1000.0));
+}
+
+// reference implementation matching the per element MMatrixToMat44_data helpers
+static void referenceTransposeMat44(const double * src, float * dst, size_t count)
+{
+  for(size_t m = 0; m < count; m++, src += 16, dst += 16)
+    for(int r = 0; r < 4; r++)
+      for(int c = 0; c < 4; c++)
+        dst[c * 4 + r] = (float)src[r * 4 + c];
+}
+
+template<typename A, typename B>
+static bool compare(char const * label, const A * a, const B * b, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    if(fabs((double)a[i] - (double)b[i]) > 1e-5 * (1.0 + fabs((double)a[i])))
+    {
+      printf("%s: mismatch at %u (%g != %g)\n", label, (unsigned)i, (double)a[i], (double)b[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  size_t numElements = argc > 1 ? (size_t)atoi(argv[1]) : 10000;
+  unsigned numIterations = argc > 2 ? (unsigned)atoi(argv[2]) : 200;
+  if(numElements == 0 || numIterations == 0)
+  {
+    printf("usage: %s [numElements] [numIterations]\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<double> mayaMatrices(numElements * 16);
+  for(size_t i = 0; i < mayaMatrices.size(); i++)
+    mayaMatrices[i] = (double)(rand() % 10000) * 0.01 - 50.0;
+
+  std::vector<float> klMatrices(numElements * 16);
+  std::vector<float> klReference(numElements * 16);
+  std::vector<double> klMatrices_d(numElements * 16);
+  std::vector<double> roundTrip(numElements * 16);
+  std::vector<float> klVectors(numElements * 3);
+  std::vector<double> mayaVectors(numElements * 3);
+  std::vector<float> klColors(numElements * 4, 1.0f);
+
+  // correctness against the scalar path before timing anything
+  referenceTransposeMat44(&mayaMatrices[0], &klReference[0], numElements);
+  dfgTransposeMat44(&mayaMatrices[0], &klMatrices[0], numElements);
+  dfgTransposeMat44(&klMatrices[0], &roundTrip[0], numElements);
+  dfgTransposeMat44(&mayaMatrices[0], &klMatrices_d[0], numElements);
+  if(!compare("Mat44 narrow", &klReference[0], &klMatrices[0], klMatrices.size())
+    || !compare("Mat44 widen", &mayaMatrices[0], &roundTrip[0], roundTrip.size())
+    || !compare("Mat44_d", &klReference[0], &klMatrices_d[0], klMatrices_d.size()))
+    return 1;
+
+  printf("%u elements, %u iterations\n", (unsigned)numElements, numIterations);
+
+  clock_t start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    referenceTransposeMat44(&mayaMatrices[0], &klReference[0], numElements);
+    s_sink += klReference[i % klReference.size()];
+  }
+  report("Mat44 MMatrix -> Float32 (scalar)", elapsedMs(start), numElements, numIterations);
+
+  start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    dfgTransposeMat44(&mayaMatrices[0], &klMatrices[0], numElements);
+    s_sink += klMatrices[i % klMatrices.size()];
+  }
+  report("Mat44 MMatrix -> Float32 (kernel)", elapsedMs(start), numElements, numIterations);
+
+  start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    dfgTransposeMat44(&klMatrices[0], &roundTrip[0], numElements);
+    s_sink += roundTrip[i % roundTrip.size()];
+  }
+  report("Mat44 Float32 -> MMatrix (kernel)", elapsedMs(start), numElements, numIterations);
+
+  start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    dfgTransposeMat44(&mayaMatrices[0], &klMatrices_d[0], numElements);
+    s_sink += klMatrices_d[i % klMatrices_d.size()];
+  }
+  report("Mat44 MMatrix -> Float64 (kernel)", elapsedMs(start), numElements, numIterations);
+
+  start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    dfgNarrowFloat64ToFloat32(&mayaMatrices[0], &klVectors[0], klVectors.size());
+    s_sink += klVectors[i % klVectors.size()];
+  }
+  report("Vec3 MVector -> Float32 (kernel)", elapsedMs(start), numElements, numIterations);
+
+  start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    dfgWidenFloat32ToFloat64(&klVectors[0], &mayaVectors[0], klVectors.size());
+    s_sink += mayaVectors[i % mayaVectors.size()];
+  }
+  report("Vec3 Float32 -> MVector (kernel)", elapsedMs(start), numElements, numIterations);
+
+  start = clock();
+  for(unsigned i = 0; i < numIterations; i++)
+  {
+    dfgPackFloat64x3ToFloat32x4(&mayaVectors[0], &klColors[0], numElements);
+    s_sink += klColors[i % klColors.size()];
+  }
+  report("Color / Euler double3 -> Float32x4", elapsedMs(start), numElements, numIterations);
+
+  printf("(checksum %g)\n", s_sink);
+  return 0;
+}
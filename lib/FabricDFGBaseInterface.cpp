@@ -16,6 +16,10 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <set>
+#include <map>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include <FTL/AutoSet.h>
 #include <FTL/JSONValue.h>
@@ -32,6 +36,9 @@
 #include <maya/MAnimControl.h>
 #include <maya/MQtUtil.h>
 #include <maya/MFileIO.h>
+#include <maya/MMutexLock.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MSelectionList.h>
 
 #if MAYA_API_VERSION >= 201600
 # include <maya/MEvaluationNode.h>
@@ -39,12 +46,77 @@
 #endif
 
 std::vector<FabricDFGBaseInterface*> FabricDFGBaseInterface::_instances;
+std::map<unsigned int, FabricDFGBaseInterface*> FabricDFGBaseInterface::_instancesById;
+std::multimap<unsigned int, FabricDFGBaseInterface*> FabricDFGBaseInterface::_instancesByHashCode;
+std::multimap<unsigned int, FabricDFGBaseInterface::AnimCurveLink> FabricDFGBaseInterface::_animCurveLinks;
 #if MAYA_API_VERSION < 201300
   std::map<std::string, int> FabricDFGBaseInterface::_nodeCreatorCounts;
 #endif
 unsigned int FabricDFGBaseInterface::s_maxID = 1;
 bool FabricDFGBaseInterface::s_use_evalContext = true; // [FE-6287]
-MStringArray FabricDFGBaseInterface::s_queuedMelCommands;
+bool FabricDFGBaseInterface::s_deferRestore = false;
+
+// commands queued for the next idle, run in the order they were queued.
+// the generic commands all run, each one of them starts a new step. the
+// plugs to dirty, the eval ID bumps and the plugs to evaluate queued within
+// a step are coalesced and dispatched in bulk after the step's command.
+struct FabricDFGIdleQueue
+{
+  struct Step
+  {
+    std::string command;
+    std::vector<std::string> dirtyPlugs;
+    std::set<std::string> dirtyPlugSet;
+    std::vector<std::string> evalPlugs;
+    std::set<std::string> evalPlugSet;
+    std::set<unsigned int> evalIDs;
+    std::set<unsigned int> restoreIDs;
+  };
+
+  FabricDFGIdleQueue() : scheduled(false) {}
+
+  bool scheduled;
+  std::vector<Step> steps;
+
+  Step & lastStep()
+  {
+    if(steps.size() == 0)
+      steps.push_back(Step());
+    return steps.back();
+  }
+
+  void swap(FabricDFGIdleQueue & other)
+  {
+    std::swap(scheduled, other.scheduled);
+    steps.swap(other.steps);
+  }
+};
+static FabricDFGIdleQueue s_idleQueue;
+static MMutexLock s_idleQueueLock;
+
+// the referenced files read by the bindings, keyed by their resolved path.
+// an entry is reused as long as the file's modification time and size are
+// unchanged, so many nodes referencing the same file only read it once.
+// referenced files are read on the thread pool, so the cache is guarded
+// by a lock. the files are read outside of the lock, and entries no node
+// references anymore are dropped by pruneReferencedFiles.
+struct FabricDFGReferencedFile
+{
+  time_t mtime;
+  long long size;
+  std::string json;
+};
+static std::map<std::string, FabricDFGReferencedFile> s_referencedFiles;
+static MMutexLock s_referencedFilesLock;
+
+static void invalidateReferencedFile(const char * filePath)
+{
+  s_referencedFilesLock.lock();
+  std::map<std::string, FabricDFGReferencedFile>::iterator it = s_referencedFiles.find(filePath);
+  if(it != s_referencedFiles.end())
+    s_referencedFiles.erase(it);
+  s_referencedFilesLock.unlock();
+}
 
 FabricDFGBaseInterface::FabricDFGBaseInterface(
   CreateDFGBindingFunc createDFGBinding
@@ -63,6 +135,7 @@ FabricDFGBaseInterface::FabricDFGBaseInterface(
   }
 
   _restoredFromPersistenceData = false;
+  _restoreDeferred = false;
   _isTransferingInputs = false;
   _dgDirtyEnabled = true;
   _portObjectsDestroyed = false;
@@ -72,10 +145,17 @@ FabricDFGBaseInterface::FabricDFGBaseInterface(
   _isEvaluating = false;
   _dgDirtyQueued = false;
   m_evalID = 0;
+  _playbackCacheMemory = 0;
+  _playbackCacheTick = 0;
+  _playbackCacheVersion = 0;
+  _inputVersion = 0;
   m_isStoringJson = false;
+  m_hasHashCode = false;
+  m_hashCode = 0;
   _instances.push_back(this);
 
   m_id = s_maxID++;
+  _instancesById[m_id] = this;
 
   MAYADFG_CATCH_END(&stat);
 }
@@ -100,6 +180,30 @@ FabricDFGBaseInterface::~FabricDFGBaseInterface()
       break;
     }
   }
+
+  _instancesById.erase(m_id);
+  removeAnimCurveLinks();
+  if(m_hasHashCode)
+  {
+    std::multimap<unsigned int, FabricDFGBaseInterface*>::iterator it = _instancesByHashCode.lower_bound(m_hashCode);
+    for(;it != _instancesByHashCode.end() && it->first == m_hashCode;it++)
+    {
+      if(it->second == this)
+      {
+        _instancesByHashCode.erase(it);
+        break;
+      }
+    }
+  }
+}
+
+void FabricDFGBaseInterface::registerInstanceMObject()
+{
+  if(m_hasHashCode)
+    return;
+  m_hashCode = MObjectHandle(getThisMObject()).hashCode();
+  m_hasHashCode = true;
+  _instancesByHashCode.insert(std::pair<unsigned int, FabricDFGBaseInterface*>(m_hashCode, this));
 }
 
 void FabricDFGBaseInterface::constructBaseInterface(){
@@ -149,26 +253,41 @@ FabricDFGBaseInterface * FabricDFGBaseInterface::getInstanceByName(const std::st
   MGlobal::getSelectionListByName(name.c_str(), selList);
   MObject spliceMayaNodeObj;
   selList.getDependNode(0, spliceMayaNodeObj);
+  return getInstanceByMObject(spliceMayaNodeObj);
+}
 
-  for(size_t i=0;i<_instances.size();i++)
+FabricDFGBaseInterface * FabricDFGBaseInterface::getInstanceByMObject(const MObject & obj) {
+
+  if(obj.isNull())
+    return NULL;
+
+  unsigned int hashCode = MObjectHandle(obj).hashCode();
+  std::multimap<unsigned int, FabricDFGBaseInterface*>::iterator it = _instancesByHashCode.lower_bound(hashCode);
+  for(;it != _instancesByHashCode.end() && it->first == hashCode;it++)
   {
-    if(_instances[i]->getThisMObject() == spliceMayaNodeObj)
-    {
-      return _instances[i];
-    }
+    if(it->second->getThisMObject() == obj)
+      return it->second;
   }
   return NULL;
 }
 
+#if MAYA_API_VERSION >= 201600
+FabricDFGBaseInterface * FabricDFGBaseInterface::getInstanceByUuid(const MUuid & uuid) {
+
+  MSelectionList selList;
+  if(selList.add(uuid) != MS::kSuccess)
+    return NULL;
+  MObject obj;
+  selList.getDependNode(0, obj);
+  return getInstanceByMObject(obj);
+}
+#endif
+
 FabricDFGBaseInterface * FabricDFGBaseInterface::getInstanceById(unsigned int id)
 {
-  for(size_t i=0;i<_instances.size();i++)
-  {
-    if(_instances[i]->getId() == id)
-    {
-      return _instances[i];
-    }
-  }
+  std::map<unsigned int, FabricDFGBaseInterface*>::iterator it = _instancesById.find(id);
+  if(it != _instancesById.end())
+    return it->second;
   return NULL;
 }
 
@@ -196,6 +315,7 @@ FabricCore::Client FabricDFGBaseInterface::getCoreClient()
 
 FabricCore::DFGHost FabricDFGBaseInterface::getDFGHost()
 {
+  restoreDeferredBinding();
   if(m_binding.isValid())
     return m_binding.getHost();
   return FabricCore::DFGHost();
@@ -203,11 +323,13 @@ FabricCore::DFGHost FabricDFGBaseInterface::getDFGHost()
 
 FabricCore::DFGBinding FabricDFGBaseInterface::getDFGBinding()
 {
+  restoreDeferredBinding();
   return m_binding;
 }
 
 FabricCore::DFGExec FabricDFGBaseInterface::getDFGExec()
 {
+  restoreDeferredBinding();
   if(m_binding.isValid())
     return m_binding.getExec();
   return FabricCore::DFGExec();
@@ -227,10 +349,230 @@ bool FabricDFGBaseInterface::transferInputValuesToDFG(MDataBlock& data){
   ud.interf = this;
   ud.isDeformer = false;
 
+  // nothing to convert, no need to visit the arguments
+  collectDirtyInputArgs(ud.argIndices);
+  if(ud.argIndices.size() == 0)
+    return true;
+
   getDFGBinding().visitArgs(getLockType(), &FabricDFGBaseInterface::VisitInputArgsCallback, &ud);
   return true;
 }
 
+void FabricDFGBaseInterface::collectDirtyInputArgs(std::vector<unsigned int> &argIndices) const
+{
+  for(unsigned int i = 0; i < _conversionPlan.size(); ++i)
+  {
+    const ConversionPlanEntry & entry = _conversionPlan[i];
+    if(entry.attributeIndex == UINT_MAX || entry.portType == FabricCore::DFGPortType_Out)
+      continue;
+    if(entry.plugToArgResolved && entry.plugToArgFunc == NULL)
+      continue;
+    if(entry.attributeIndex >= _isAttributeIndexDirty.size() || _isAttributeIndexDirty[entry.attributeIndex])
+      argIndices.push_back(i);
+  }
+}
+
+void FabricDFGBaseInterface::collectOutputArgs(std::vector<unsigned int> &argIndices) const
+{
+  for(unsigned int i = 0; i < _conversionPlan.size(); ++i)
+  {
+    const ConversionPlanEntry & entry = _conversionPlan[i];
+    if(entry.attributeIndex == UINT_MAX || entry.portType == FabricCore::DFGPortType_In)
+      continue;
+    if(entry.argToPlugResolved && entry.argToPlugFunc == NULL)
+      continue;
+    argIndices.push_back(i);
+  }
+}
+
+// KL objects are references, so the cached values need to be
+// copies to survive the next execution of the binding.
+static FabricCore::RTVal clonePlaybackCacheValue(FabricCore::RTVal value)
+{
+  if(value.isObject())
+  {
+    if(value.isNullObject())
+      return value;
+    return value.callMethod(value.getTypeNameCStr(), "clone", 0, 0);
+  }
+  if(value.isArray() && value.getArraySize() > 0 && value.getArrayElement(0).isObject())
+  {
+    FabricCore::RTVal result = FabricSplice::constructRTVal(value.getTypeNameCStr(), 0, 0);
+    result.setArraySize(value.getArraySize());
+    for(uint32_t i = 0; i < value.getArraySize(); ++i)
+      result.setArrayElement(i, clonePlaybackCacheValue(value.getArrayElement(i)));
+    return result;
+  }
+  return value;
+}
+
+// rough estimate of the memory used by a value, good enough for the budget.
+static size_t estimatePlaybackCacheValueMemory(FabricCore::RTVal value)
+{
+  if(value.isObject())
+  {
+    if(value.isNullObject())
+      return sizeof(void*);
+    FTL::CStrRef typeName = value.getTypeNameCStr();
+    if(typeName == FTL_STR("PolygonMesh"))
+    {
+      uint64_t nbPoints = value.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
+      uint64_t nbSamples = value.callMethod("UInt64", "polygonPointsCount", 0, 0).getUInt64();
+      return size_t(nbPoints * 16 + nbSamples * 32);
+    }
+    if(typeName == FTL_STR("Lines"))
+    {
+      uint64_t nbPoints = value.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
+      return size_t(nbPoints * 24);
+    }
+    return 256;
+  }
+  if(value.isArray())
+  {
+    uint32_t size = value.getArraySize();
+    if(size == 0)
+      return 16;
+    return size * estimatePlaybackCacheValueMemory(value.getArrayElement(0));
+  }
+  return 64;
+}
+
+bool FabricDFGBaseInterface::restoreOutputsFromPlaybackCache(double time)
+{
+  if(_playbackCacheVersion != _inputVersion)
+  {
+    clearPlaybackCache();
+    return false;
+  }
+
+  std::map< double, PlaybackCacheEntry >::iterator it = _playbackCache.find(time);
+  if(it == _playbackCache.end())
+    return false;
+
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::restoreOutputsFromPlaybackCache");
+
+  // avoid the binding notifications while we set the arguments
+  FTL::AutoSet<bool> restoresOutputs(_isEvaluating, true);
+
+  PlaybackCacheEntry & entry = it->second;
+  _playbackCacheLRU.erase(entry.lastUsed);
+  entry.lastUsed = ++_playbackCacheTick;
+  _playbackCacheLRU[entry.lastUsed] = time;
+  try
+  {
+    for(size_t i = 0; i < entry.values.size(); ++i)
+    {
+      FabricCore::RTVal value = clonePlaybackCacheValue(entry.values[i].second);
+      m_binding.setArgValue(entry.values[i].first.c_str(), value, false /* canUndo */);
+    }
+  }
+  catch(FabricCore::Exception e)
+  {
+    mayaLogErrorFunc(e.getDesc_cstr());
+    clearPlaybackCache();
+    return false;
+  }
+  return true;
+}
+
+void FabricDFGBaseInterface::storeOutputsInPlaybackCache(double time, size_t memoryBudget)
+{
+  if(_playbackCacheVersion != _inputVersion)
+    clearPlaybackCache();
+
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::storeOutputsInPlaybackCache");
+
+  PlaybackCacheEntry entry;
+  entry.memory = 0;
+  entry.lastUsed = ++_playbackCacheTick;
+  try
+  {
+    FabricCore::DFGExec exec = getDFGExec();
+    for(unsigned int i = 0; i < exec.getExecPortCount(); ++i)
+    {
+      // io ports are transferred back to maya as well, so they are cached alongside the outputs
+      if(exec.getExecPortType(i) == FabricCore::DFGPortType_In)
+        continue;
+      std::string portName = exec.getExecPortName(i);
+      FabricCore::RTVal value = m_binding.getArgValue(portName.c_str());
+      if(!value.isValid())
+        continue;
+      entry.memory += estimatePlaybackCacheValueMemory(value);
+      entry.values.push_back(std::pair< std::string, FabricCore::RTVal >(portName, clonePlaybackCacheValue(value)));
+    }
+  }
+  catch(FabricCore::Exception e)
+  {
+    // the outputs can't be copied, so we don't cache this frame
+    mayaLogErrorFunc(e.getDesc_cstr());
+    return;
+  }
+
+  if(entry.memory > memoryBudget)
+    return;
+
+  std::map< double, PlaybackCacheEntry >::iterator it = _playbackCache.find(time);
+  if(it != _playbackCache.end())
+  {
+    _playbackCacheMemory -= it->second.memory;
+    _playbackCacheLRU.erase(it->second.lastUsed);
+    _playbackCache.erase(it);
+  }
+
+  // evict the least recently used frames until the new one fits
+  while(_playbackCacheLRU.size() > 0 && _playbackCacheMemory + entry.memory > memoryBudget)
+  {
+    std::map< unsigned int, double >::iterator oldest = _playbackCacheLRU.begin();
+    std::map< double, PlaybackCacheEntry >::iterator oldestEntry = _playbackCache.find(oldest->second);
+    if(oldestEntry != _playbackCache.end())
+    {
+      _playbackCacheMemory -= oldestEntry->second.memory;
+      _playbackCache.erase(oldestEntry);
+    }
+    _playbackCacheLRU.erase(oldest);
+  }
+
+  _playbackCache.insert(std::pair< double, PlaybackCacheEntry >(time, entry));
+  _playbackCacheLRU[entry.lastUsed] = time;
+  _playbackCacheMemory += entry.memory;
+  _playbackCacheVersion = _inputVersion;
+}
+
+void FabricDFGBaseInterface::clearPlaybackCache()
+{
+  _playbackCache.clear();
+  _playbackCacheLRU.clear();
+  _playbackCacheMemory = 0;
+  _playbackCacheVersion = _inputVersion;
+}
+
+void FabricDFGBaseInterface::bumpInputVersion(MPlug const &inPlug)
+{
+  // inputs whose direct source is the time node or a time based anim curve
+  // are covered by the cache key, everything else invalidates the cached frames.
+  // we don't walk further upstream: an input driven by time through other
+  // nodes (expressions, constraints, ...) also invalidates the cache.
+  if(!_playbackCache.empty())
+  {
+    MPlugArray sources;
+    if(inPlug.connectedTo(sources, true /* asDst */, false /* asSrc */) && sources.length() > 0)
+    {
+      switch(sources[0].node().apiType())
+      {
+        case MFn::kTime:
+        case MFn::kAnimCurveTimeToAngular:
+        case MFn::kAnimCurveTimeToDistance:
+        case MFn::kAnimCurveTimeToTime:
+        case MFn::kAnimCurveTimeToUnitless:
+          return;
+        default:
+          break;
+      }
+    }
+  }
+  _inputVersion++;
+}
+
 void FabricDFGBaseInterface::evaluate(){
 
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::evaluate");
@@ -279,6 +621,10 @@ void FabricDFGBaseInterface::transferOutputValuesToMaya(MDataBlock& data, bool i
   ud.interf = this;
   ud.isDeformer = isDeformer;
 
+  collectOutputArgs(ud.argIndices);
+  if(ud.argIndices.size() == 0)
+    return;
+
   getDFGBinding().visitArgs(getLockType(), &FabricDFGBaseInterface::VisitOutputArgsCallback, &ud);
 }
 
@@ -287,14 +633,17 @@ void FabricDFGBaseInterface::collectDirtyPlug(MPlug const &inPlug){
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::collectDirtyPlug");
 
   // [hmathee 20161110] take a short cut - if we find the attribute index
-  // based on the attribute name then we can exit
+  // based on the attribute object then we can exit
   {
-    MString attrName = MFnAttribute(inPlug.attribute()).name();
-    FTL::StrRef attrNameRef = attrName.asChar();
-    FTL::OrderedStringMap< unsigned int >::const_iterator it = _attributeNameToIndex.find(attrNameRef);
-    if(it != _attributeNameToIndex.end())
+    unsigned int index;
+    if(findAttributeObjectIndex(inPlug.attribute(), index))
     {
-      _isAttributeIndexDirty[it->value()] = true;
+      if(index == UINT_MAX)
+        return;
+      while(index >= _isAttributeIndexDirty.size())
+        _isAttributeIndexDirty.push_back(true);
+      _isAttributeIndexDirty[index] = true;
+      bumpInputVersion(inPlug);
       return;
     }
   }
@@ -309,6 +658,9 @@ void FabricDFGBaseInterface::collectDirtyPlug(MPlug const &inPlug){
   if(nameRef == FTL_STR("saveData") || 
     nameRef == FTL_STR("refFilePath") || 
     nameRef == FTL_STR("enableEvalContext") ||
+    nameRef == FTL_STR("batchDeform") ||
+    nameRef == FTL_STR("playbackCache") ||
+    nameRef == FTL_STR("playbackCacheMemory") ||
     nameRef == FTL_STR("nodeState") ||
     nameRef == FTL_STR("caching") ||
     nameRef == FTL_STR("frozen"))
@@ -336,34 +688,83 @@ void FabricDFGBaseInterface::collectDirtyPlug(MPlug const &inPlug){
   }
 
   // todo: get the attribute index
-  FTL::OrderedStringMap< unsigned int >::const_iterator it = _attributeNameToIndex.find(nameRef);
+  std::map< std::string, unsigned int >::const_iterator it = _attributeNameToIndex.find(std::string(nameRef.data(), nameRef.size()));
   if(it != _attributeNameToIndex.end())
   {
-    unsigned int index = it->value();
+    unsigned int index = it->second;
     while(index >= _isAttributeIndexDirty.size())
     {
       _isAttributeIndexDirty.push_back(true);
     }
     _isAttributeIndexDirty[index] = true;
+    bumpInputVersion(inPlug);
   }
 }
 
+void FabricDFGBaseInterface::setAttributeObjectIndex(MObject const &attribute, unsigned int index)
+{
+  AttributeObjectIndex entry;
+  entry.attribute = attribute;
+  entry.index = index;
+  unsigned int hashCode = MObjectHandle(attribute).hashCode();
+  _attributeObjectToIndex.insert(std::pair< unsigned int, AttributeObjectIndex >(hashCode, entry));
+}
+
+bool FabricDFGBaseInterface::findAttributeObjectIndex(MObject const &attribute, unsigned int &index) const
+{
+  unsigned int hashCode = MObjectHandle(attribute).hashCode();
+  std::multimap< unsigned int, AttributeObjectIndex >::const_iterator it = _attributeObjectToIndex.lower_bound(hashCode);
+  for(;it != _attributeObjectToIndex.end() && it->first == hashCode;it++)
+  {
+    if(it->second.attribute == attribute)
+    {
+      index = it->second.index;
+      return true;
+    }
+  }
+  return false;
+}
+
 void FabricDFGBaseInterface::generateAttributeLookups() 
 {
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::generateAttributeLookups");
 
   _attributeNameToIndex.clear();
-  _plugToArgFuncs.resize(0);
-  _argToPlugFuncs.resize(0);
+  _attributeObjectToIndex.clear();
+
+  appendAttributeLookups(0);
+  generateConversionPlan();
+}
+
+void FabricDFGBaseInterface::updateAttributeLookups()
+{
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::updateAttributeLookups");
 
+  // new attributes are appended to the node, so as long as the
+  // attributes we know about are still in place we only need to
+  // look at the new ones.
+  MFnDependencyNode thisNode(getThisMObject());
+  unsigned int knownCount = _attributePlugs.length();
+  if(knownCount == 0 || knownCount > thisNode.attributeCount() ||
+    _attributePlugs[knownCount-1].attribute() != thisNode.attribute(knownCount-1))
+  {
+    generateAttributeLookups();
+    return;
+  }
+
+  appendAttributeLookups(knownCount);
+  generateConversionPlan();
+}
+
+void FabricDFGBaseInterface::appendAttributeLookups(unsigned int firstIndex)
+{
   MFnDependencyNode thisNode(getThisMObject());
-  FabricCore::DFGExec exec = getDFGBinding().getExec();
 
   // FE-7682 Reducing the length of the plugArray makes Maya crash
   // because it invokes the destruction of the plug  the plug has already been deleted.   
   // http://download.autodesk.com/us/maya/2011help/api/class_m_plug_array.html#97f9b95167d95e3512ab82b559263ba3   
   // _attributePlugs.setLength(thisNode.attributeCount());
-  for(unsigned int i = 0; i < thisNode.attributeCount(); ++i)
+  for(unsigned int i = firstIndex; i < thisNode.attributeCount(); ++i)
   {
     MFnAttribute attrib(thisNode.attribute(i));
 
@@ -382,10 +783,16 @@ void FabricDFGBaseInterface::generateAttributeLookups()
     if(attrNameRef == FTL_STR("saveData") || 
       attrNameRef == FTL_STR("refFilePath") || 
       attrNameRef == FTL_STR("enableEvalContext") ||
+      attrNameRef == FTL_STR("batchDeform") ||
+      attrNameRef == FTL_STR("playbackCache") ||
+      attrNameRef == FTL_STR("playbackCacheMemory") ||
       attrNameRef == FTL_STR("nodeState") ||
       attrNameRef == FTL_STR("caching") ||
       attrNameRef == FTL_STR("frozen"))
+    {
+      setAttributeObjectIndex(thisNode.attribute(i), UINT_MAX);
       continue;
+    }
 
     // find the top level attribute
     MPlug plug(getThisMObject(), thisNode.attribute(i));
@@ -405,59 +812,71 @@ void FabricDFGBaseInterface::generateAttributeLookups()
     // where 3 is the index of the positions attribute.
     MFnAttribute parentAttribute(plug.attribute());
     MString parentAttributeName = parentAttribute.name();
-    FTL::StrRef parentAttributeNameRef = parentAttributeName.asChar();
-    FTL::OrderedStringMap< unsigned int >::const_iterator it = _attributeNameToIndex.find(parentAttributeNameRef);
-    if(it != _attributeNameToIndex.end())
-      _attributeNameToIndex.insert(attrib.name().asChar(), it->value());
-    else
-      _attributeNameToIndex.insert(attrib.name().asChar(), i);
+    std::map< std::string, unsigned int >::const_iterator it = _attributeNameToIndex.find(parentAttributeName.asChar());
+    unsigned int index = it != _attributeNameToIndex.end() ? it->second : i;
+    _attributeNameToIndex.insert(std::pair< std::string, unsigned int >(attrib.name().asChar(), index));
+    setAttributeObjectIndex(thisNode.attribute(i), index);
   }
 
   for(unsigned int i = thisNode.attributeCount(); i < _attributePlugs.length(); ++i)
     _attributePlugs.remove(i);
+}
 
+void FabricDFGBaseInterface::renameAttributeLookups(MPlug const &plug, MString oldName, MString newName)
+{
+  if(plug.isNull())
+    return;
 
-  _argIndexToAttributeIndex.resize(exec.getExecPortCount());
-  _plugToArgFuncs.resize(exec.getExecPortCount());
-  _argToPlugFuncs.resize(exec.getExecPortCount());
-  for(unsigned i = 0; i < exec.getExecPortCount(); ++i)
+  // the plug is already renamed, the names of its children
+  // start with the new name in place of the old one.
+  MFnAttribute attrib(plug.attribute());
+  MString attrName = attrib.name();
+  MString oldAttrName = oldName + attrName.substring(newName.length(), attrName.length());
+
+  std::map< std::string, unsigned int >::iterator it = _attributeNameToIndex.find(oldAttrName.asChar());
+  if(it != _attributeNameToIndex.end())
   {
-    _argIndexToAttributeIndex[i] = UINT_MAX;
-    _plugToArgFuncs[i] = NULL;
-    _argToPlugFuncs[i] = NULL;
-    MString argName = exec.getExecPortName(i);
-    MString plugName = getPlugName(argName);
-    for(unsigned j=0;j<thisNode.attributeCount();j++)
-    {
-      MFnAttribute attrib(thisNode.attribute(j));
-      if(attrib.name() == plugName)
-      {
-        _argIndexToAttributeIndex[i] = j;
-        break;
-      }
-    }
+    unsigned int index = it->second;
+    _attributeNameToIndex.erase(it);
+    _attributeNameToIndex[attrName.asChar()] = index;
   }
+
+  for(unsigned int i=0;i<plug.numChildren();i++)
+    renameAttributeLookups(plug.child(i), oldName, newName);
 }
 
-void FabricDFGBaseInterface::affectChildPlugs(MPlug &plug, MPlugArray &affectedPlugs){
-  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::affectChildPlugs");
-  if(plug.isNull()){
-    return;
-  }
+void FabricDFGBaseInterface::generateConversionPlan()
+{
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::generateConversionPlan");
 
-  for(size_t i = 0; i < plug.numChildren(); ++i){
-    MPlug childPlug = plug.child(i);
-    if(!childPlug.isNull()){
-      affectedPlugs.append(childPlug);
-      affectChildPlugs(childPlug, affectedPlugs);
-    }
-  }
+  // the cached outputs might not match the ports anymore
+  clearPlaybackCache();
+
+  MFnDependencyNode thisNode(getThisMObject());
+  FabricCore::DFGExec exec = getDFGBinding().getExec();
 
-  for(size_t i = 0; i < plug.numElements(); ++i){
-    MPlug elementPlug = plug.elementByPhysicalIndex(i);
-    if(!elementPlug.isNull()){
-      affectedPlugs.append(elementPlug);
-      affectChildPlugs(elementPlug, affectedPlugs);
+  _conversionPlan.resize(0);
+  _conversionPlan.resize(exec.getExecPortCount());
+  for(unsigned i = 0; i < exec.getExecPortCount(); ++i)
+  {
+    ConversionPlanEntry & entry = _conversionPlan[i];
+    entry.attributeIndex = UINT_MAX;
+    entry.portType = exec.getExecPortType(i);
+    entry.plugToArgResolved = false;
+    entry.argToPlugResolved = false;
+    entry.plugToArgFunc = NULL;
+    entry.argToPlugFunc = NULL;
+
+    // the port attributes are top level attributes, so
+    // their name maps onto their own attribute index.
+    MString argName = exec.getExecPortName(i);
+    MString plugName = getPlugName(argName);
+    std::map< std::string, unsigned int >::const_iterator it = _attributeNameToIndex.find(plugName.asChar());
+    if(it != _attributeNameToIndex.end())
+    {
+      MFnAttribute attrib(thisNode.attribute(it->second));
+      if(attrib.name() == plugName)
+        entry.attributeIndex = it->second;
     }
   }
 }
@@ -467,6 +886,10 @@ void FabricDFGBaseInterface::storePersistenceData(MString file, MStatus *stat){
 
   MAYADFG_CATCH_BEGIN(stat);
 
+  // deferred bindings still have their json in the saveData data block
+  if(_restoreDeferred)
+    return;
+
   FTL::AutoSet<bool> storingJson(m_isStoringJson, true);
 
   std::string json = m_binding.exportJSON().getCString();
@@ -476,55 +899,132 @@ void FabricDFGBaseInterface::storePersistenceData(MString file, MStatus *stat){
   MAYADFG_CATCH_END(stat);
 }
 
+bool FabricDFGBaseInterface::readReferencedFile(const char * filePath, std::string & json)
+{
+  struct stat fileStat;
+  if(stat(filePath, &fileStat) != 0)
+  {
+    invalidateReferencedFile(filePath);
+    return false;
+  }
+
+  bool cached = false;
+  s_referencedFilesLock.lock();
+  std::map<std::string, FabricDFGReferencedFile>::iterator it = s_referencedFiles.find(filePath);
+  if(it != s_referencedFiles.end()
+    && it->second.mtime == fileStat.st_mtime
+    && it->second.size == (long long)fileStat.st_size)
+  {
+    json = it->second.json;
+    cached = true;
+  }
+  s_referencedFilesLock.unlock();
+  if(cached)
+    return true;
+
+  FILE * file = fopen(filePath, "rb");
+  if(!file)
+  {
+    invalidateReferencedFile(filePath);
+    return false;
+  }
+
+  fseek( file, 0, SEEK_END );
+  long fileSize = ftell( file );
+  rewind( file );
+
+  json.resize(fileSize);
+  if(fileSize > 0)
+  {
+    size_t readBytes = fread(&json[0], 1, fileSize, file);
+    assert(readBytes == size_t(fileSize));
+    (void)readBytes;
+  }
+
+  fclose(file);
+
+  s_referencedFilesLock.lock();
+  FabricDFGReferencedFile & entry = s_referencedFiles[filePath];
+  entry.json = json;
+  entry.mtime = fileStat.st_mtime;
+  entry.size = (long long)fileStat.st_size;
+  s_referencedFilesLock.unlock();
+  return true;
+}
+
+void FabricDFGBaseInterface::pruneReferencedFiles()
+{
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::pruneReferencedFiles");
+
+  std::set<std::string> filePaths;
+  for(size_t i=0;i<_instances.size();i++)
+  {
+    MString refFilePath = _instances[i]->getRefFilePathPlug().asString();
+    if(refFilePath.length() > 0)
+      filePaths.insert(resolveEnvironmentVariables(refFilePath).asChar());
+  }
+
+  s_referencedFilesLock.lock();
+  std::map<std::string, FabricDFGReferencedFile>::iterator it = s_referencedFiles.begin();
+  while(it != s_referencedFiles.end())
+  {
+    if(filePaths.find(it->first) != filePaths.end())
+    {
+      it++;
+      continue;
+    }
+    s_referencedFiles.erase(it++);
+  }
+  s_referencedFilesLock.unlock();
+}
+
 void FabricDFGBaseInterface::restoreFromPersistenceData(MString file, MStatus *stat){
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::restoreFromPersistenceData");
   if(_restoredFromPersistenceData)
     return;
 
   MPlug saveDataPlug = getSaveDataPlug();
-  MString json = saveDataPlug.asString();
   MPlug refFilePathPlug = getRefFilePathPlug();
+  restoreFromSavedData(saveDataPlug.asString(), refFilePathPlug.asString(), stat);
+}
 
+void FabricDFGBaseInterface::restoreFromSavedData(MString json, MString refFilePath, MStatus *stat){
   _isReferenced = false;
 
-  MString refFilePath = refFilePathPlug.asString();
   if(refFilePath.length() > 0)
   {
     MString resolvedRefFilePath = resolveEnvironmentVariables(refFilePath);
     if(resolvedRefFilePath != refFilePath)
       mayaLogFunc("Referenced file path '"+refFilePath+"' resolved to '"+resolvedRefFilePath+"'.");
 
-    FILE * file = fopen(resolvedRefFilePath.asChar(), "rb");
-    if(!file)
+    std::string refJson;
+    if(!readReferencedFile(resolvedRefFilePath.asChar(), refJson))
     {
       mayaLogErrorFunc("Referenced file path '"+refFilePath+"' cannot be opened, falling back to locally saved json.");
     }
     else
     {
-      fseek( file, 0, SEEK_END );
-      long fileSize = ftell( file );
-      rewind( file );
-
-      char * buffer = (char*) malloc(fileSize + 1);
-      buffer[fileSize] = '\0';
-
-      size_t readBytes = fread(buffer, 1, fileSize, file);
-      assert(readBytes == size_t(fileSize));
-      (void)readBytes;
-
-      fclose(file);
-
-      json = buffer;
-      free(buffer);
-
       _isReferenced = true;
+      restoreFromJSON(MString(refJson.c_str(), (int)refJson.length()), stat);
+      return;
     }
   }
 
   restoreFromJSON(json, stat);
 }
 
-void FabricDFGBaseInterface::restoreFromJSON(MString json, MStatus *stat){
+void FabricDFGBaseInterface::restoreDeferredBinding(){
+  if(!_restoreDeferred)
+    return;
+
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::restoreDeferredBinding");
+
+  _restoreDeferred = false;
+  _restoredFromPersistenceData = false;
+  restoreFromPersistenceData(mayaGetLastLoadedScene());
+}
+
+void FabricDFGBaseInterface::restoreFromJSON(const MString & json, MStatus *stat){
   if(_restoredFromPersistenceData)
     return;
 
@@ -607,9 +1107,7 @@ void FabricDFGBaseInterface::restoreFromJSON(MString json, MStatus *stat){
     FabricCore::DFGPortType portType = exec.getExecPortType(i);
     if(portType != FabricCore::DFGPortType_Out)
     {
-      MString command("dgeval ");
-      // MGlobal::executeCommandOnIdle(command+thisNode.name()+"."+plugName);
-      queueMelCommand(command+thisNode.name()+"."+plugName);
+      queueEvaluatePlug(thisNode.name()+"."+plugName);
       break;
     }
   }
@@ -643,6 +1141,10 @@ void FabricDFGBaseInterface::reloadFromReferencedFilePath()
   if(filePath.length() == 0)
     return;
 
+  // the file is reloaded explicitly, so don't trust the cached content
+  // in case the modification time didn't change.
+  invalidateReferencedFile(resolveEnvironmentVariables(filePath).asChar());
+
   _restoredFromPersistenceData = false;
   MStatus status;
   restoreFromPersistenceData(mayaGetLastLoadedScene(), &status);
@@ -654,6 +1156,9 @@ MString FabricDFGBaseInterface::getPlugName(const MString &portName)
   else if (portName == "saveData")           return "dfg_saveData";
   else if (portName == "refFilePath")        return "dfg_refFilePath";
   else if (portName == "enableEvalContext")  return "dfg_enableEvalContext";
+  else if (portName == "batchDeform")        return "dfg_batchDeform";
+  else if (portName == "playbackCache")      return "dfg_playbackCache";
+  else if (portName == "playbackCacheMemory") return "dfg_playbackCacheMemory";
   else                                       return portName;
 }
 
@@ -663,6 +1168,9 @@ MString FabricDFGBaseInterface::getPortName(const MString &plugName)
   else if (plugName == "dfg_saveData")          return "saveData";
   else if (plugName == "dfg_refFilePath")       return "refFilePath";
   else if (plugName == "dfg_enableEvalContext") return "enableEvalContext";
+  else if (plugName == "dfg_batchDeform")       return "batchDeform";
+  else if (plugName == "dfg_playbackCache")     return "playbackCache";
+  else if (plugName == "dfg_playbackCacheMemory") return "playbackCacheMemory";
   else                                          return plugName;
 }
 
@@ -692,9 +1200,7 @@ void FabricDFGBaseInterface::invalidatePlug(MPlug & plug)
   if(!_dgDirtyQueued)
   {
     _dgDirtyQueued = true;
-    MString command("dgdirty ");
-    // MGlobal::executeCommandOnIdle(command+plugName);
-    queueMelCommand(command+plugName);
+    queueDirtyPlug(plug);
   }
 
   if(plugName.index('.') > -1)
@@ -740,11 +1246,18 @@ void FabricDFGBaseInterface::invalidateNode()
 {
   if(!_dgDirtyEnabled)
     return;
+  // the node is invalidated once its binding has been restored
+  if(_restoreDeferred)
+    return;
 
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::invalidateNode");
 
   MFnDependencyNode thisNode(getThisMObject());
 
+  // the port values might have been replaced, so start over with the meshes
+  dfgClearPolygonMeshCache(getThisMObject());
+  clearPlaybackCache();
+
   unsigned int dirtiedInputs = 0;
 
   FabricCore::DFGExec exec = getDFGExec();
@@ -768,6 +1281,13 @@ void FabricDFGBaseInterface::invalidateNode()
       }
     }
 
+    // the overrides affect the conversion functions
+    for(size_t i = 0; i < _conversionPlan.size(); ++i)
+    {
+      _conversionPlan[i].plugToArgResolved = false;
+      _conversionPlan[i].argToPlugResolved = false;
+    }
+
     // ensure that the node is invalidated
     for(unsigned int i = 0; i < exec.getExecPortCount(); ++i){
       std::string portName = exec.getExecPortName(i);
@@ -779,23 +1299,19 @@ void FabricDFGBaseInterface::invalidateNode()
         if(portType == FabricCore::DFGPortType_In)
         {
           collectDirtyPlug(plug);
-          MPlugArray plugs;
-          plug.connectedTo(plugs,true,false);
-          for(size_t j=0;j<plugs.length();j++)
-            invalidatePlug(plugs[j]);
           dirtiedInputs++;
-        }
-        else
-        {
-          invalidatePlug(plug);
-
           MPlugArray plugs;
-          affectChildPlugs(plug, plugs);
+          plug.connectedTo(plugs,true,false);
           for(size_t j=0;j<plugs.length();j++)
             invalidatePlug(plugs[j]);
         }
       }
     }
+
+    // the outputs, including their children and elements
+    rebuildAffectedPlugs();
+    for(unsigned int i = 0; i < _affectedPlugs.length(); ++i)
+      invalidatePlug(_affectedPlugs[i]);
   }
 
   // if there are no inputs on this 
@@ -805,7 +1321,7 @@ void FabricDFGBaseInterface::invalidateNode()
     queueIncrementEvalID(true /* onIdle */);
   }
 
-  _affectedPlugsDirty = true;
+  _affectedPlugsDirty = !exec.isValid();
   _outputsDirtied = false;
 }
 
@@ -815,12 +1331,7 @@ void FabricDFGBaseInterface::queueIncrementEvalID(bool onIdle)
 
   if(_dgDirtyQueued || onIdle)
   {
-    MString command("FabricCanvasIncrementEvalID -index ");
-    MString indexStr;
-    indexStr.set((int)m_id);
-
-    // MGlobal::executeCommandOnIdle(command+indexStr, false /*display*/);
-    queueMelCommand(command+indexStr);
+    queueIncrementEvalIDById(m_id);
   }
   else
   {
@@ -832,62 +1343,276 @@ void FabricDFGBaseInterface::incrementEvalID()
 {
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::incrementEvalID");
 
-  MFnDependencyNode thisNode(getThisMObject());
-  MPlug evalIDPlug = thisNode.findPlug("evalID");
+  MPlug evalIDPlug = getEvalIDPlug();
   if(evalIDPlug.isNull())
     return;
 
+  // setting the plug directly dirties the node's outputs
+  // without going through the MEL parser and the undo queue
   m_evalID++;
+  evalIDPlug.setInt((int)m_evalID);
+}
 
-  MString plugName = evalIDPlug.name();
-  MString command("setAttr ");
-  MString evalIDStr;
-  evalIDStr.set(m_evalID);
-
-  MGlobal::executeCommand(command+plugName+" "+evalIDStr, false /*display*/, false /*undoable*/);
+// needs to be called with the queue locked
+static void scheduleIdleQueue()
+{
+  if(s_idleQueue.scheduled)
+    return;
+  s_idleQueue.scheduled = true;
+  MGlobal::executeCommandOnIdle("FabricCanvasProcessMelQueue;");
 }
 
 void FabricDFGBaseInterface::queueMelCommand(MString cmd)
 {
-  // todo: this needs to use a mutex~!
-  s_queuedMelCommands.append(cmd);
-  if(s_queuedMelCommands.length() == 1)
-    MGlobal::executeCommandOnIdle("FabricCanvasProcessMelQueue;");
+  s_idleQueueLock.lock();
+  s_idleQueue.steps.push_back(FabricDFGIdleQueue::Step());
+  s_idleQueue.steps.back().command = cmd.asChar();
+  scheduleIdleQueue();
+  s_idleQueueLock.unlock();
+}
+
+void FabricDFGBaseInterface::queueDirtyPlug(MString plugName)
+{
+  s_idleQueueLock.lock();
+  FabricDFGIdleQueue::Step & step = s_idleQueue.lastStep();
+  std::string str = plugName.asChar();
+  if(step.dirtyPlugSet.insert(str).second)
+    step.dirtyPlugs.push_back(str);
+  scheduleIdleQueue();
+  s_idleQueueLock.unlock();
+}
+
+void FabricDFGBaseInterface::queueDirtyPlug(MPlug const &plug)
+{
+  // the plugs of this node are dirtied through the API: the attribute is
+  // flagged for the next transfer and the eval ID bump on idle dirties the
+  // outputs, as any input change does in setDependentsDirty.
+  if(plug.node() == getThisMObject())
+  {
+    collectDirtyPlug(plug);
+    queueIncrementEvalIDById(m_id);
+    return;
+  }
+
+  // the API has no way to dirty another node's plug without setting
+  // its value, so those go through a single dgdirty per step.
+  queueDirtyPlug(plug.name());
+}
+
+void FabricDFGBaseInterface::queueEvaluatePlug(MString plugName)
+{
+  s_idleQueueLock.lock();
+  FabricDFGIdleQueue::Step & step = s_idleQueue.lastStep();
+  std::string str = plugName.asChar();
+  if(step.evalPlugSet.insert(str).second)
+    step.evalPlugs.push_back(str);
+  scheduleIdleQueue();
+  s_idleQueueLock.unlock();
+}
+
+void FabricDFGBaseInterface::queueIncrementEvalIDById(unsigned int id)
+{
+  s_idleQueueLock.lock();
+  s_idleQueue.lastStep().evalIDs.insert(id);
+  scheduleIdleQueue();
+  s_idleQueueLock.unlock();
+}
+
+void FabricDFGBaseInterface::queueRestoreDeferredBinding()
+{
+  s_idleQueueLock.lock();
+  s_idleQueue.lastStep().restoreIDs.insert(m_id);
+  scheduleIdleQueue();
+  s_idleQueueLock.unlock();
 }
 
 MStatus FabricDFGBaseInterface::processQueuedMelCommands()
 {
-  // todo: this needs to use a mutex~!
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::processQueuedMelCommands");
+
+  // take the queue over, so that the commands
+  // executed below can queue up new entries
+  FabricDFGIdleQueue queue;
+  s_idleQueueLock.lock();
+  queue.swap(s_idleQueue);
+  s_idleQueueLock.unlock();
+
   MStatus result = MS::kSuccess;
-  for(unsigned int i=0;i<s_queuedMelCommands.length();i++)
+  for(size_t stepIndex=0;stepIndex<queue.steps.size();stepIndex++)
   {
-    MStatus st = MGlobal::executeCommand(s_queuedMelCommands[i]);
-    if(st != MS::kSuccess)
-      result = st;
+    FabricDFGIdleQueue::Step & step = queue.steps[stepIndex];
+
+    if(step.command.length() > 0)
+    {
+      MStatus st = MGlobal::executeCommand(step.command.c_str());
+      if(st != MS::kSuccess)
+        result = st;
+    }
+
+    // restoring a binding invalidates the node, which
+    // queues the dirtying and evaluation of its plugs.
+    for(std::set<unsigned int>::iterator it=step.restoreIDs.begin();it!=step.restoreIDs.end();it++)
+    {
+      FabricDFGBaseInterface * interf = getInstanceById(*it);
+      if(interf)
+        interf->restoreDeferredBinding();
+    }
+
+    // a single dgdirty for all of the plugs
+    if(step.dirtyPlugs.size() > 0)
+    {
+      MString command("dgdirty");
+      for(size_t i=0;i<step.dirtyPlugs.size();i++)
+        command += MString(" \"") + step.dirtyPlugs[i].c_str() + "\"";
+      MStatus st = MGlobal::executeCommand(command, false /*display*/, false /*undoable*/);
+      if(st != MS::kSuccess)
+        result = st;
+    }
+
+    for(std::set<unsigned int>::iterator it=step.evalIDs.begin();it!=step.evalIDs.end();it++)
+    {
+      FabricDFGBaseInterface * interf = getInstanceById(*it);
+      if(interf)
+        interf->incrementEvalID();
+    }
+
+    // pull on the plugs to force an evaluation
+    for(size_t i=0;i<step.evalPlugs.size();i++)
+    {
+      MSelectionList list;
+      MPlug plug;
+      if(list.add(step.evalPlugs[i].c_str()) != MS::kSuccess || list.getPlug(0, plug) != MS::kSuccess)
+      {
+        result = MS::kFailure;
+        continue;
+      }
+      MDataHandle handle = plug.asMDataHandle();
+      plug.destructHandle(handle);
+    }
   }
-  s_queuedMelCommands.clear();
+
   return result;
 }
 
-bool FabricDFGBaseInterface::plugInArray(const MPlug &plug, const MPlugArray &array){
-  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::plugInArray");
+void FabricDFGBaseInterface::rebuildAffectedPlugs()
+{
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::rebuildAffectedPlugs");
+
+  _affectedPlugs.clear();
+  _affectedPlugIndices.clear();
 
-  bool found = false;
-  for(size_t i = 0; i < array.length(); ++i){
-    if(array[i] == plug){
-      found = true;
-      break;
+  // without a binding the outputs are the readable dynamic
+  // attributes, which are created for the Out and IO ports.
+  if(_restoreDeferred)
+  {
+    MFnDependencyNode thisNode(getThisMObject());
+    for(unsigned int i = 0; i < thisNode.attributeCount(); ++i)
+    {
+      MFnAttribute attr(thisNode.attribute(i));
+      if(!attr.isDynamic() || !attr.isReadable() || !attr.parent().isNull())
+        continue;
+      addAffectedPlug(MPlug(getThisMObject(), attr.object()));
     }
+    return;
+  }
+
+  FabricCore::DFGExec exec = getDFGExec();
+  if(!exec.isValid())
+    return;
+
+  MFnDependencyNode thisNode(getThisMObject());
+  for(unsigned int i = 0; i < exec.getExecPortCount(); ++i)
+  {
+    if(exec.getExecPortType(i) == FabricCore::DFGPortType_In)
+      continue;
+    MString plugName = getPlugName(exec.getExecPortName(i));
+    addAffectedPlug(thisNode.findPlug(plugName));
+  }
+}
+
+void FabricDFGBaseInterface::addAffectedPlug(MPlug const &plug)
+{
+  if(plug.isNull())
+    return;
+
+  // the children and elements are added together with the plug
+  MString name = plug.partialName();
+  FTL::StrRef nameRef = name.asChar();
+  if(_affectedPlugIndices.find(nameRef) != _affectedPlugIndices.end())
+    return;
+  _affectedPlugIndices.insert(nameRef, _affectedPlugs.length());
+  _affectedPlugs.append(plug);
+
+  for(unsigned int i = 0; i < plug.numChildren(); ++i)
+    addAffectedPlug(plug.child(i));
+  for(unsigned int i = 0; i < plug.numElements(); ++i)
+    addAffectedPlug(plug.elementByPhysicalIndex(i));
+}
+
+void FabricDFGBaseInterface::removeAffectedPlugs(MPlug const &plug)
+{
+  if(plug.isNull())
+    return;
+
+  // removes the plug along with its children and elements. a top level
+  // plug is matched by its attribute, an element or child by the plug.
+  bool isTopLevel = !plug.isChild() && !plug.isElement();
+  MObject attribute = plug.attribute();
+  MPlugArray remaining;
+  for(unsigned int i = 0; i < _affectedPlugs.length(); ++i)
+  {
+    bool found = false;
+    MPlug parentPlug = _affectedPlugs[i];
+    while(!found)
+    {
+      if(isTopLevel)
+        found = !parentPlug.isChild() && !parentPlug.isElement() && parentPlug.attribute() == attribute;
+      else
+        found = parentPlug == plug;
+      if(!parentPlug.isChild() && !parentPlug.isElement())
+        break;
+      parentPlug = parentPlug.isChild() ? parentPlug.parent() : parentPlug.array();
+    }
+    if(!found)
+      remaining.append(_affectedPlugs[i]);
+  }
+
+  _affectedPlugs = remaining;
+  reindexAffectedPlugs();
+}
+
+// whether the plug or one of its children drives a plug other than otherPlug
+static bool hasOtherDestinations(MPlug const &plug, MPlug const &otherPlug)
+{
+  MPlugArray destinations;
+  plug.connectedTo(destinations, false /* asDst */, true /* asSrc */);
+  for(unsigned int i = 0; i < destinations.length(); ++i)
+  {
+    if(destinations[i] != otherPlug)
+      return true;
+  }
+  for(unsigned int i = 0; i < plug.numChildren(); ++i)
+  {
+    if(hasOtherDestinations(plug.child(i), otherPlug))
+      return true;
+  }
+  return false;
+}
+
+void FabricDFGBaseInterface::reindexAffectedPlugs()
+{
+  _affectedPlugIndices.clear();
+  for(unsigned int i = 0; i < _affectedPlugs.length(); ++i)
+  {
+    MString name = _affectedPlugs[i].partialName();
+    _affectedPlugIndices.insert(name.asChar(), i);
   }
-  return found;
 }
 
 MStatus FabricDFGBaseInterface::setDependentsDirty(MObject thisMObject, MPlug const &inPlug, MPlugArray &affectedPlugs){
 
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::setDependentsDirty");
 
-  MFnDependencyNode thisNode(thisMObject);
-
   // we can't ask for the plug value here, so we fill an array for the compute to only transfer newly dirtied values
   collectDirtyPlug(inPlug);
 
@@ -900,57 +1625,24 @@ MStatus FabricDFGBaseInterface::setDependentsDirty(MObject thisMObject, MPlug co
   if(_outputsDirtied && !emConstructionActive)
     return MS::kSuccess;
 
-  if(_affectedPlugsDirty || emConstructionActive)
+  if(_affectedPlugsDirty)
   {
-    FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::setDependentsDirty _affectedPlugsDirty");
-    
-    _affectedPlugs.clear();
-
-    // todo: performance considerations
-    for(unsigned int i = 0; i < thisNode.attributeCount(); ++i){
-      MFnAttribute attrib(thisNode.attribute(i));
-
-      // [hmathe 20161108] some nodes might have static attributes that need to be dirtied
-      //if(!attrib.isDynamic())
-      MString attrName = attrib.name();
-      FTL::StrRef attrNameRef = attrName.asChar();
-      if(attrNameRef == FTL_STR("saveData") || 
-        attrNameRef == FTL_STR("refFilePath") || 
-        attrNameRef == FTL_STR("enableEvalContext") ||
-        attrNameRef == FTL_STR("nodeState") ||
-        attrNameRef == FTL_STR("caching") ||
-        attrNameRef == FTL_STR("frozen"))
-        continue;
-
-      // check if the attribute is an output
-      // otherwise continue
-      try
-      {
-        FabricCore::DFGExec exec = getDFGExec();
-        FabricCore::DFGPortType portType = exec.getExecPortType(attrib.name().asChar());
-        if(portType == FabricCore::DFGPortType_In)
-          continue;
-      }
-      catch(FabricCore::Exception e)
-      {
-        continue;
-      }
-
-      MPlug outPlug = thisNode.findPlug(attrib.name());
-      if(!outPlug.isNull()){
-        if(!plugInArray(outPlug, _affectedPlugs)){
-          _affectedPlugs.append(outPlug);
-          affectChildPlugs(outPlug, _affectedPlugs);
-        }
-      }
-    }
-
+    rebuildAffectedPlugs();
     _affectedPlugsDirty = false;
   }
 
+  // the outputs don't affect each other, and the array might already
+  // hold the plugs from attributeAffects, so we append the outputs to it
+  // for inputs only.
+  MString inPlugName = inPlug.partialName();
+  if(_affectedPlugIndices.find(inPlugName.asChar()) != _affectedPlugIndices.end())
+    return MS::kSuccess;
+
   {
-    FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::setDependentsDirty copy _affectedPlugs");
-    affectedPlugs = _affectedPlugs;
+    FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::setDependentsDirty append _affectedPlugs");
+    affectedPlugs.setSizeIncrement(_affectedPlugs.length());
+    for(unsigned int i = 0; i < _affectedPlugs.length(); ++i)
+      affectedPlugs.append(_affectedPlugs[i]);
   }
 
   _outputsDirtied = true;
@@ -963,7 +1655,7 @@ void FabricDFGBaseInterface::copyInternalData(MPxNode *node){
 
   if (node)
   {
-    FabricDFGBaseInterface *otherInterface = getInstanceByName(node->name().asChar());
+    FabricDFGBaseInterface *otherInterface = getInstanceByMObject(node->thisMObject());
     if (otherInterface)
     {
       MStatus stat = MS::kSuccess;
@@ -978,6 +1670,10 @@ bool FabricDFGBaseInterface::getInternalValueInContext(const MPlug &plug, MDataH
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::getInternalValueInContext");
 
   if(plug.partialName() == "saveData" || plug.partialName() == "svd"){
+    // without a binding the json is kept in the data block
+    if(_restoreDeferred || !m_binding.isValid())
+      return false;
+
     // somebody is pulling on the save data, let's persist it either way
     MStatus stat = MS::kSuccess;
     MAYADFG_CATCH_BEGIN(&stat);
@@ -994,9 +1690,15 @@ bool FabricDFGBaseInterface::setInternalValueInContext(const MPlug &plug, const
   if(plug.partialName() == "saveData" || plug.partialName() == "svd"){
     if(!m_isStoringJson)
     {
+      // deferred bindings are restored on first use, so while a file is
+      // opened keep the json in the data block.
+      if(s_deferRestore && MFileIO::isOpeningFile() && !m_binding.isValid())
+        return false;
+
       MString json = dataHandle.asString();
       if(json.length() > 0)
       {
+        _restoreDeferred = false;
         if(m_lastJson != json)
         {
           MStatus st;
@@ -1014,8 +1716,7 @@ void FabricDFGBaseInterface::onNodeAdded(MObject &node, void *clientData)
 {
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::onNodeAdded");
 
-  MFnDependencyNode thisNode(node);
-  FabricDFGBaseInterface * interf = getInstanceByName(thisNode.name().asChar());
+  FabricDFGBaseInterface * interf = getInstanceByMObject(node);
   if( interf )
   {
     // reattach
@@ -1037,8 +1738,7 @@ void FabricDFGBaseInterface::onNodeRemoved(MObject &node, void *clientData)
 {
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::onNodeRemoved");
 
-  MFnDependencyNode thisNode(node);
-  FabricDFGBaseInterface *interf = getInstanceByName(thisNode.name().asChar());
+  FabricDFGBaseInterface *interf = getInstanceByMObject(node);
 
   if (interf)
   {
@@ -1067,48 +1767,104 @@ void FabricDFGBaseInterface::onAnimCurveEdited(MObjectArray &editedCurves, void
 
   for (unsigned int i=0;i<editedCurves.length();i++)
   {
-    // get the curve and its connected plugs.
-    MFnAnimCurve curve(editedCurves[i]);
-    MPlugArray curvePlugs;
-    if (curve.getConnections(curvePlugs) != MS::kSuccess)
-      continue;
+    // the converted KeyframeTracks of this curve are outdated.
+    dfgPlugToPort_KeyframeTrack_invalidate(editedCurves[i]);
+    plugToPort_KeyframeTrack_invalidate(editedCurves[i]);
 
-    // go through the connected plugs and check
-    // if they are connected to a Canvas node.
-    for (unsigned int j=0;j<curvePlugs.length();j++)
+    // mark the inputs driven by the curve directly
+    MObjectHandle curveHandle(editedCurves[i]);
+    unsigned int hashCode = curveHandle.hashCode();
+    std::multimap<unsigned int, AnimCurveLink>::iterator it = _animCurveLinks.lower_bound(hashCode);
+    for(;it != _animCurveLinks.end() && it->first == hashCode;it++)
     {
-      // get the plug and its connections.
-      MPlug &curvePlug = curvePlugs[j];
-      MPlugArray destPlugs;
-      if (!curvePlug.connectedTo(destPlugs, false /* asDst */, true /* asSrc */) || !destPlugs.length())
-        continue;
+      if(it->second.curve == curveHandle)
+        it->second.interf->invalidateAnimCurveTarget(it->second.plug);
+    }
+  }
+}
 
-      // go through the connected plugs and
-      // check if they belong to a Canvas node.
-      for (unsigned int k=0;k<destPlugs.length();k++)
-      {
-        MPlug &destPlug = destPlugs[k];
+void FabricDFGBaseInterface::invalidateAnimCurveTarget(const MPlug &plug)
+{
+  unsigned int index;
+  if(findAttributeObjectIndex(plug.attribute(), index) && index < _isAttributeIndexDirty.size())
+    _isAttributeIndexDirty[index] = true;
 
-        std::string n = destPlug.name().asChar();
-        size_t t = n.find_last_of('.');
-        if (t == std::string::npos)
-          continue;
+  // the curve is part of the cache key through the time only
+  clearPlaybackCache();
 
-        FabricDFGBaseInterface *b = getInstanceByName(n.substr(0, t).c_str());
-        if (b)  b->invalidatePlug(destPlug);
-      }
+  if(_dgDirtyEnabled)
+    queueDirtyPlug(plug);
+}
+
+void FabricDFGBaseInterface::updateAnimCurveLink(const MPlug &plug, const MPlug &curvePlug, bool made)
+{
+  MObject curveNode = curvePlug.node();
+  if(!curveNode.hasFn(MFn::kAnimCurve))
+    return;
+
+  MObjectHandle curveHandle(curveNode);
+  unsigned int hashCode = curveHandle.hashCode();
+  std::multimap<unsigned int, AnimCurveLink>::iterator it = _animCurveLinks.lower_bound(hashCode);
+  for(;it != _animCurveLinks.end() && it->first == hashCode;it++)
+  {
+    if(it->second.interf == this && it->second.curve == curveHandle && it->second.plug == plug)
+    {
+      if(!made)
+        _animCurveLinks.erase(it);
+      return;
     }
   }
+
+  if(made)
+  {
+    AnimCurveLink link;
+    link.curve = curveHandle;
+    link.interf = this;
+    link.plug = plug;
+    _animCurveLinks.insert(std::pair<unsigned int, AnimCurveLink>(hashCode, link));
+  }
+}
+
+void FabricDFGBaseInterface::removeAnimCurveLinks()
+{
+  std::multimap<unsigned int, AnimCurveLink>::iterator it = _animCurveLinks.begin();
+  while(it != _animCurveLinks.end())
+  {
+    if(it->second.interf == this)
+      _animCurveLinks.erase(it++);
+    else
+      it++;
+  }
 }
 
 void FabricDFGBaseInterface::onConnection(const MPlug &plug, const MPlug &otherPlug, bool asSrc, bool made)
 {
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::onConnection");
 
-  _affectedPlugsDirty = true;
+  // connected output elements need to be dirtied as well, and
+  // are dropped again once their last connection is broken
+  if(asSrc && plug.node() == getThisMObject())
+  {
+    MPlug elementPlug = plug;
+    while(elementPlug.isChild())
+      elementPlug = elementPlug.parent();
+    if(elementPlug.isElement())
+    {
+      MString arrayName = elementPlug.array().partialName();
+      if(_affectedPlugIndices.find(arrayName.asChar()) != _affectedPlugIndices.end())
+      {
+        if(made)
+          addAffectedPlug(elementPlug);
+        else if(!hasOtherDestinations(elementPlug, otherPlug))
+          removeAffectedPlugs(elementPlug);
+      }
+    }
+  }
 
   if(!asSrc)
   {
+    updateAnimCurveLink(plug, otherPlug, made);
+
     MString plugName = plug.name();
 
     if(plugName.index('.') > -1)
@@ -1127,13 +1883,18 @@ void FabricDFGBaseInterface::onConnection(const MPlug &plug, const MPlug &otherP
           // if there are no connections,
           // ensure to disable the conversion
           getDFGExec().setExecPortMetadata(plugName.asChar(), "disableSpliceMayaDataConversion", made ? "false" : "true", false /* canUndo */);
+
+          // the metadata affects the conversion functions
+          for(size_t i = 0; i < _conversionPlan.size(); ++i)
+          {
+            _conversionPlan[i].plugToArgResolved = false;
+            _conversionPlan[i].argToPlugResolved = false;
+          }
         }
         break;
       }
     }
   }
-
-  generateAttributeLookups();
 }
 
 // ********************   ********************  //
@@ -1386,10 +2147,10 @@ inline bool AddBaseTypeAttributes(
   }
   else if(arrayType == "Array (Native)")
   {
-    if(numType == MFnNumericData::kDouble)
+    if(numType == MFnNumericData::kDouble || numType == MFnNumericData::kFloat)
       newAttribute = tAttr.create(plugName, plugName, MFnData::kDoubleArray);
       
-    else if(numType == MFnNumericData::kInt)
+    else if(numType == MFnNumericData::kInt || numType == MFnNumericData::kShort || numType == MFnNumericData::kByte)
       newAttribute = tAttr.create(plugName, plugName, MFnData::kIntArray);
 
     else
@@ -1636,9 +2397,8 @@ inline bool AddBaseStructAttributes(
   }
   else if(arrayType == "Array (Native)")
   {
-    if( binding.getExec().isExecPortResolvedType(portIndex, "Vec3") || 
-      binding.getExec().isExecPortResolvedType(portIndex, "Vec3[]") ) 
-    newAttribute = tAttr.create(plugName, plugName, MFnData::kVectorArray);
+    if(nbParameter == 3 && (numType == MFnNumericData::kFloat || numType == MFnNumericData::kDouble))
+      newAttribute = tAttr.create(plugName, plugName, MFnData::kVectorArray);
 
     else
     {
@@ -2188,17 +2948,18 @@ MObject FabricDFGBaseInterface::addMayaAttribute(MString portName, MString dataT
   if(!compoundChild)
     setupMayaAttributeAffects(portName, portType, newAttribute);
 
-  generateAttributeLookups();
+  updateAttributeLookups();
 
   // FE-7923: if this is an in or io plug ensure to 
   // invalidate it.
+  MPlug newAttributePlug(getThisMObject(), newAttribute);
   if(portType != FabricCore::DFGPortType_Out)
-  {
-    MPlug newAttributePlug(getThisMObject(), newAttribute);
     invalidatePlug(newAttributePlug);
-  }
 
-  _affectedPlugsDirty = true;
+  // out and io plugs are dirtied by the inputs
+  if(portType != FabricCore::DFGPortType_In)
+    addAffectedPlug(newAttributePlug);
+
   return newAttribute;
 
   MAYADFG_CATCH_END(stat);
@@ -2217,9 +2978,9 @@ void FabricDFGBaseInterface::removeMayaAttribute(MString portName, MStatus * sta
   MPlug plug = thisNode.findPlug(plugName);
   if(!plug.isNull())
   {
+    removeAffectedPlugs(plug);
     thisNode.removeAttribute(plug.attribute());
     generateAttributeLookups();
-    _affectedPlugsDirty = true;
   }
 
   MAYASPLICE_CATCH_END(stat);
@@ -2343,12 +3104,125 @@ void FabricDFGBaseInterface::allStorePersistenceData(MString file, MStatus *stat
     _instances[i]->storePersistenceData(file, stat);
 }
 
+// a referenced file read ahead of the binding creation. this is the only
+// part of restoring a binding which involves neither the Maya API nor KL.
+struct FabricDFGReferencedFilePrefetch
+{
+  std::string filePath;
+  std::string json;
+  bool valid;
+};
+
+struct FabricDFGRestoreTask
+{
+  FabricDFGBaseInterface * interf;
+  MString json;
+  MString refFilePath;
+  unsigned int prefetchIndex;
+};
+
+void FabricDFGBaseInterface::PrefetchReferencedFileTask(void * userData, unsigned int index)
+{
+  FabricDFGReferencedFilePrefetch & prefetch = (*(std::vector<FabricDFGReferencedFilePrefetch> *)userData)[index];
+
+  // failures fall back to the locally saved json
+  try
+  {
+    prefetch.valid = readReferencedFile(prefetch.filePath.c_str(), prefetch.json);
+  }
+  catch(...)
+  {
+    prefetch.valid = false;
+  }
+}
+
 void FabricDFGBaseInterface::allRestoreFromPersistenceData(MString file, MStatus *stat)
 {
   FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::allRestoreFromPersistenceData");
 
+  // deferred bindings are restored on first compute or first access
+  if(s_deferRestore)
+  {
+    for(size_t i=0;i<_instances.size();i++)
+    {
+      FabricDFGBaseInterface * interf = _instances[i];
+      if(interf->_restoredFromPersistenceData || interf->m_binding.isValid())
+        continue;
+      interf->_restoreDeferred = true;
+      interf->_affectedPlugsDirty = true;
+    }
+    pruneReferencedFiles();
+    return;
+  }
+
+  // gather the plug values on the main thread, prefetch the distinct
+  // referenced files on the thread pool, and then create the bindings on
+  // the main thread, in the order of the instances. the bindings themselves
+  // can't be built concurrently: createBindingFromJSON is synchronous, it
+  // compiles KL and the core has no async variant of it, and the client
+  // can't be entered from Maya's thread pool. reading the files is what
+  // stalls on layouts referencing many graphs on network storage, so only
+  // that part goes through dfgParallelFor.
+  std::vector<FabricDFGRestoreTask> tasks;
+  std::vector<FabricDFGReferencedFilePrefetch> prefetches;
+  std::map<std::string, unsigned int> prefetchIndices;
+  tasks.reserve(_instances.size());
   for(size_t i=0;i<_instances.size();i++)
-    _instances[i]->restoreFromPersistenceData(file, stat);
+  {
+    FabricDFGBaseInterface * interf = _instances[i];
+    if(interf->_restoredFromPersistenceData)
+      continue;
+
+    interf->constructBaseInterface();
+
+    FabricDFGRestoreTask task;
+    task.interf = interf;
+    task.json = interf->getSaveDataPlug().asString();
+    task.refFilePath = interf->getRefFilePathPlug().asString();
+    task.prefetchIndex = UINT_MAX;
+    if(task.refFilePath.length() > 0)
+    {
+      MString resolvedRefFilePath = resolveEnvironmentVariables(task.refFilePath);
+      if(resolvedRefFilePath != task.refFilePath)
+        mayaLogFunc("Referenced file path '"+task.refFilePath+"' resolved to '"+resolvedRefFilePath+"'.");
+
+      // each distinct file is read once, however many nodes reference it
+      std::string filePath = resolvedRefFilePath.asChar();
+      std::map<std::string, unsigned int>::iterator it = prefetchIndices.find(filePath);
+      if(it == prefetchIndices.end())
+      {
+        FabricDFGReferencedFilePrefetch prefetch;
+        prefetch.filePath = filePath;
+        prefetch.valid = false;
+        it = prefetchIndices.insert(std::pair<std::string, unsigned int>(filePath, (unsigned int)prefetches.size())).first;
+        prefetches.push_back(prefetch);
+      }
+      task.prefetchIndex = it->second;
+    }
+    tasks.push_back(task);
+  }
+
+  {
+    FabricMayaProfilingEvent bracket("prefetching referenced files");
+    dfgParallelFor((unsigned int)prefetches.size(), PrefetchReferencedFileTask, &prefetches);
+  }
+
+  for(size_t i=0;i<tasks.size();i++)
+  {
+    FabricDFGRestoreTask & task = tasks[i];
+    FabricDFGReferencedFilePrefetch * prefetch = NULL;
+    if(task.prefetchIndex != UINT_MAX)
+      prefetch = &prefetches[task.prefetchIndex];
+    task.interf->_isReferenced = prefetch && prefetch->valid;
+    if(prefetch && !prefetch->valid)
+      mayaLogErrorFunc("Referenced file path '"+task.refFilePath+"' cannot be opened, falling back to locally saved json.");
+    if(task.interf->_isReferenced)
+      task.interf->restoreFromJSON(MString(prefetch->json.c_str(), (int)prefetch->json.length()), stat);
+    else
+      task.interf->restoreFromJSON(task.json, stat);
+  }
+
+  pruneReferencedFiles();
 }
 
 void FabricDFGBaseInterface::allResetInternalData()
@@ -2407,7 +3281,10 @@ void FabricDFGBaseInterface::bindingNotificationCallback(
     // when we receive this notification we need to 
     // ensure that the DCC reevaluates the node
     if(!_isEvaluating && !_isTransferingInputs)
+    {
+      clearPlaybackCache();
       queueIncrementEvalID(false /* onIdle */);
+    }
   }
   else if( descStr == FTL_STR("argTypeChanged") )
   {
@@ -2454,11 +3331,17 @@ void FabricDFGBaseInterface::bindingNotificationCallback(
     MPlug plug = thisNode.findPlug(oldPlugName);
     renamePlug(plug, oldPlugName, newPlugName);
 
-    generateAttributeLookups();
+    // the affected plugs are indexed by their partial name
+    reindexAffectedPlugs();
+
+    // the attribute objects, their indices and with that the
+    // conversion plan stay the same, only the names change.
+    renameAttributeLookups(plug, oldPlugName, newPlugName);
   }
   else if( descStr == FTL_STR("argInserted") )
   {
-    generateAttributeLookups();
+    // the argument indices have shifted, the attributes are added separately
+    generateConversionPlan();
   }
   else if(   descStr == FTL_STR("varInserted")
           || descStr == FTL_STR("varRemoved") )
@@ -2493,23 +3376,20 @@ void FabricDFGBaseInterface::VisitInputArgsCallback(
   if(argOutsidePortType == FabricCore::DFGPortType_Out)
     return;
 
-  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::VisitInputArgsCallback");
-
   VisitCallbackUserData * ud = (VisitCallbackUserData *)userdata;
 
-  assert(argIndex < ud->interf->_argIndexToAttributeIndex.size());
-  unsigned int attributeIndex = ud->interf->_argIndexToAttributeIndex[argIndex];
-  if(attributeIndex == UINT_MAX)
+  // only the dirty arguments collected from the plan are converted
+  if(!ud->isNextArg(argIndex))
     return;
+  ConversionPlanEntry & entry = ud->interf->_conversionPlan[argIndex];
+  unsigned int attributeIndex = entry.attributeIndex;
 
-  assert(attributeIndex < ud->interf->_isAttributeIndexDirty.size());
-  if(!ud->interf->_isAttributeIndexDirty[attributeIndex])
-   return;
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::VisitInputArgsCallback");
 
   MPlug plug = ud->interf->_attributePlugs[attributeIndex];
 
-  DFGPlugToArgFunc func = ud->interf->_plugToArgFuncs[argIndex];
-  if(func == NULL)
+  DFGPlugToArgFunc func = entry.plugToArgFunc;
+  if(!entry.plugToArgResolved)
   {
     FabricMayaProfilingEvent bracket("finding conversion func");
 
@@ -2528,9 +3408,10 @@ void FabricDFGBaseInterface::VisitInputArgsCallback(
     }
 
     func = getDFGPlugToArgFunc(portDataType);
+    entry.plugToArgFunc = func;
+    entry.plugToArgResolved = true;
     if(func == NULL)
       return;
-    ud->interf->_plugToArgFuncs[argIndex] = func;
   }
 
   {
@@ -2572,18 +3453,19 @@ void FabricDFGBaseInterface::VisitOutputArgsCallback(
   if(argOutsidePortType == FabricCore::DFGPortType_In)
     return;
 
-  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::VisitOutputArgsCallback");
-
   VisitCallbackUserData * ud = (VisitCallbackUserData *)userdata;
 
-  assert(argIndex < ud->interf->_argIndexToAttributeIndex.size());
-  unsigned int attributeIndex = ud->interf->_argIndexToAttributeIndex[argIndex];
-  if(attributeIndex == UINT_MAX)
+  if(!ud->isNextArg(argIndex))
     return;
+  ConversionPlanEntry & entry = ud->interf->_conversionPlan[argIndex];
+  unsigned int attributeIndex = entry.attributeIndex;
+
+  FabricMayaProfilingEvent bracket("FabricDFGBaseInterface::VisitOutputArgsCallback");
+
   MPlug plug = ud->interf->_attributePlugs[attributeIndex];
 
-  DFGArgToPlugFunc func = ud->interf->_argToPlugFuncs[argIndex];
-  if(func == NULL)
+  DFGArgToPlugFunc func = entry.argToPlugFunc;
+  if(!entry.argToPlugResolved)
   {
     FabricMayaProfilingEvent bracket("getting conversion func");
 
@@ -2604,12 +3486,16 @@ void FabricDFGBaseInterface::VisitOutputArgsCallback(
       //data.setClean(plug);  // [FE-6087]
                               // 'setClean()' need not be called for MPxDeformerNode.
                               // (see comments of FE-6087 for more detailed information)
+    {
+      entry.argToPlugResolved = true;
       return;
+    }
 
     func = getDFGArgToPlugFunc(portDataType);
+    entry.argToPlugFunc = func;
+    entry.argToPlugResolved = true;
     if(func == NULL)
       return;
-    ud->interf->_argToPlugFuncs[argIndex] = func;
   }
 
   {
@@ -11,6 +11,7 @@
 #include "FabricDFGConversion.h"
 
 #include <vector>
+#include <map>
 
 #include <maya/MFnDependencyNode.h> 
 #include <maya/MPlug.h> 
@@ -22,6 +23,10 @@
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnMatrixAttribute.h>
+#include <maya/MObjectHandle.h>
+#if MAYA_API_VERSION >= 201600
+# include <maya/MUuid.h>
+#endif
 
 #include <FabricSplice.h>
 #include <Commands/CommandStack.h>
@@ -55,8 +60,14 @@ public:
   FabricDFGBaseInterface( CreateDFGBindingFunc createDFGBinding );
   virtual ~FabricDFGBaseInterface();
   void constructBaseInterface();
+  // to be called from the postConstructor, once the MObject is valid
+  void registerInstanceMObject();
 
   static FabricDFGBaseInterface * getInstanceByName(const std::string & name);
+  static FabricDFGBaseInterface * getInstanceByMObject(const MObject & obj);
+#if MAYA_API_VERSION >= 201600
+  static FabricDFGBaseInterface * getInstanceByUuid(const MUuid & uuid);
+#endif
   static FabricDFGBaseInterface * getInstanceById(unsigned int id);
   static FabricDFGBaseInterface * getInstanceByIndex(unsigned int index);
   static unsigned int getNumInstances();
@@ -65,6 +76,7 @@ public:
   virtual MPlug getSaveDataPlug() = 0;
   virtual MPlug getRefFilePathPlug() = 0;
   virtual MPlug getEnableEvalContextPlug() = 0;
+  virtual MPlug getEvalIDPlug() = 0;
 
   unsigned int getId() const;
   FabricCore::Client getCoreClient();
@@ -75,7 +87,7 @@ public:
 
   void storePersistenceData(MString file, MStatus *stat = 0);
   void restoreFromPersistenceData(MString file, MStatus *stat = 0);
-  void restoreFromJSON(MString json, MStatus *stat = 0);
+  void restoreFromJSON(const MString & json, MStatus *stat = 0);
   void setReferencedFilePath(MString filePath);
   void reloadFromReferencedFilePath();
 
@@ -98,7 +110,13 @@ public:
   virtual void queueIncrementEvalID(bool onIdle = true);
   virtual void incrementEvalID();
 
+  // the queue is processed on idle and can be filled from any thread.
+  // identical entries are only queued once.
   static void queueMelCommand(MString cmd);
+  static void queueDirtyPlug(MString plugName);
+  void queueDirtyPlug(MPlug const &plug);
+  static void queueEvaluatePlug(MString plugName);
+  static void queueIncrementEvalIDById(unsigned int id);
   static MStatus processQueuedMelCommands();
 
   DFGUICmdHandler_Maya *getCmdHandler()
@@ -120,14 +138,73 @@ protected:
   // private members and helper methods
   bool _restoredFromPersistenceData;
 
+  // with s_deferRestore the bindings aren't created when the scene is
+  // opened, but on first compute or first access to the binding. until
+  // then the json stays in the saveData data block and the affected
+  // plugs are derived from the node's dynamic attributes. a compute or
+  // deform only queues the restore, which runs on idle on the main thread.
+  bool _restoreDeferred;
+  void restoreDeferredBinding();
+  void queueRestoreDeferredBinding();
+
   // FabricSplice::DGGraph _spliceGraph;
   // MStringArray _dirtyPlugs;
-  std::vector< unsigned int > _argIndexToAttributeIndex;
   std::vector< bool > _isAttributeIndexDirty;
-  FTL::OrderedStringMap< unsigned int > _attributeNameToIndex;
+  // the attribute index per attribute name, child attributes map to
+  // their top level attribute's index.
+  std::map< std::string, unsigned int > _attributeNameToIndex;
+  void renameAttributeLookups(MPlug const &plug, MString oldName, MString newName);
+  // the attribute index per attribute object, keyed by the hash code of
+  // the attribute. child attributes map to their top level attribute,
+  // attributes which aren't transferred map to UINT_MAX.
+  struct AttributeObjectIndex
+  {
+    MObject attribute;
+    unsigned int index;
+  };
+  std::multimap< unsigned int, AttributeObjectIndex > _attributeObjectToIndex;
+  void setAttributeObjectIndex(MObject const &attribute, unsigned int index);
+  bool findAttributeObjectIndex(MObject const &attribute, unsigned int &index) const;
   MPlugArray _attributePlugs;
-  std::vector< DFGPlugToArgFunc > _plugToArgFuncs;
-  std::vector< DFGArgToPlugFunc > _argToPlugFuncs;
+
+  // the conversion plan holds one entry per binding argument. it is
+  // built by generateAttributeLookups and only changes with the ports,
+  // the conversion functions are resolved on the first transfer.
+  struct ConversionPlanEntry
+  {
+    unsigned int attributeIndex;
+    FabricCore::DFGPortType portType;
+    bool plugToArgResolved;
+    bool argToPlugResolved;
+    DFGPlugToArgFunc plugToArgFunc;
+    DFGArgToPlugFunc argToPlugFunc;
+  };
+  std::vector< ConversionPlanEntry > _conversionPlan;
+  void collectDirtyInputArgs(std::vector<unsigned int> &argIndices) const;
+  void collectOutputArgs(std::vector<unsigned int> &argIndices) const;
+
+  // the playback cache holds the output values of previous evaluations
+  // keyed by time. the entries are only valid for the input version they
+  // were stored with - any change to an input which isn't driven by time
+  // bumps the version and drops the cache on the next lookup.
+  struct PlaybackCacheEntry
+  {
+    std::vector< std::pair< std::string, FabricCore::RTVal > > values;
+    size_t memory;
+    unsigned int lastUsed;
+  };
+  std::map< double, PlaybackCacheEntry > _playbackCache;
+  // the times of the cached frames ordered by their last use
+  std::map< unsigned int, double > _playbackCacheLRU;
+  size_t _playbackCacheMemory;
+  unsigned int _playbackCacheTick;
+  unsigned int _playbackCacheVersion;
+  unsigned int _inputVersion;
+
+  bool restoreOutputsFromPlaybackCache(double time);
+  void storeOutputsInPlaybackCache(double time, size_t memoryBudget);
+  void clearPlaybackCache();
+  void bumpInputVersion(MPlug const &inPlug);
 
   bool _isTransferingInputs;
   bool _portObjectsDestroyed;
@@ -138,7 +215,9 @@ protected:
   virtual void transferOutputValuesToMaya(MDataBlock& data, bool isDeformer = false);
   virtual void collectDirtyPlug(MPlug const &inPlug);
   virtual void generateAttributeLookups();
-  void affectChildPlugs(MPlug &plug, MPlugArray &affectedPlugs);
+  void updateAttributeLookups();
+  void appendAttributeLookups(unsigned int firstIndex);
+  void generateConversionPlan();
   void copyInternalData(MPxNode *node);
   bool getInternalValueInContext(const MPlug &plug, MDataHandle &dataHandle, MDGContext &ctx);
   bool setInternalValueInContext(const MPlug &plug, const MDataHandle &dataHandle, MDGContext &ctx);
@@ -179,12 +258,37 @@ protected:
   bool _isEvaluating;
   bool _dgDirtyQueued;
   unsigned int m_evalID;
+
+  // the output plugs dirtied by any input, indexed by their partial name.
+  // the set is rebuilt when _affectedPlugsDirty is set and otherwise
+  // maintained as output attributes and connections come and go.
   MPlugArray _affectedPlugs;
+  FTL::OrderedStringMap< unsigned int > _affectedPlugIndices;
+  void rebuildAffectedPlugs();
+  void addAffectedPlug(MPlug const &plug);
+  void removeAffectedPlugs(MPlug const &plug);
+  void reindexAffectedPlugs();
 
 #if MAYA_API_VERSION < 201300
   static std::map<std::string, int> _nodeCreatorCounts;
 #endif
   static std::vector<FabricDFGBaseInterface*> _instances;
+  // the instances indexed by id and by the hash code of their MObject
+  static std::map<unsigned int, FabricDFGBaseInterface*> _instancesById;
+  static std::multimap<unsigned int, FabricDFGBaseInterface*> _instancesByHashCode;
+
+  // the input plugs driven by anim curves, indexed by
+  // the hash code of the curve. maintained in onConnection.
+  struct AnimCurveLink
+  {
+    MObjectHandle curve;
+    FabricDFGBaseInterface * interf;
+    MPlug plug;
+  };
+  static std::multimap<unsigned int, AnimCurveLink> _animCurveLinks;
+  void updateAnimCurveLink(const MPlug &plug, const MPlug &curvePlug, bool made);
+  void removeAnimCurveLinks();
+  void invalidateAnimCurveTarget(const MPlug &plug);
 
   FabricCore::Client m_client;
   FabricServices::ASTWrapper::KLASTManager * m_manager;
@@ -215,7 +319,18 @@ protected:
     : node(inNode)
     , data(inData)
     , returnValue(0)
+    , nextArg(0)
+    {
+    }
+
+    // the arguments to convert in increasing order, taken from the
+    // conversion plan. visitArgs walks all arguments, the callbacks
+    // skip the ones not in here.
+    bool isNextArg(unsigned argIndex)
     {
+      while(nextArg < argIndices.size() && argIndices[nextArg] < argIndex)
+        nextArg++;
+      return nextArg < argIndices.size() && argIndices[nextArg] == argIndex;
     }
 
     FabricDFGBaseInterface * interf;
@@ -224,6 +339,8 @@ protected:
     MPlug meshPlug;
     MDataBlock & data;
     int returnValue;
+    std::vector<unsigned int> argIndices;
+    size_t nextArg;
   };
 
 private:
@@ -258,12 +375,17 @@ private:
     void *getSetUD
     );  
 
-  bool plugInArray(const MPlug &plug, const MPlugArray &array);
   void renamePlug(const MPlug &plug, MString oldName, MString newName);
   static MString resolveEnvironmentVariables(const MString & filePath);
+  void restoreFromSavedData(MString json, MString refFilePath, MStatus *stat = 0);
+  static bool readReferencedFile(const char * filePath, std::string & json);
+  static void pruneReferencedFiles();
+  static void PrefetchReferencedFileTask(void * userData, unsigned int index);
 
   unsigned int m_id;
   static unsigned int s_maxID;
+  bool m_hasHashCode;
+  unsigned int m_hashCode;
   bool m_executeSharedDirty;
   bool m_executeShared;
   MString m_lastJson;
@@ -275,7 +397,7 @@ public:
   static bool s_use_evalContext;
 
 public:
-  static MStringArray s_queuedMelCommands;
+  static bool s_deferRestore;
 
 public:
 
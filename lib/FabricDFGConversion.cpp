@@ -6,6 +6,7 @@
 #include "FabricSpliceMayaData.h"
 #include "FabricSpliceHelpers.h"
 #include "FabricDFGProfiling.h"
+#include "FabricDFGConversionKernels.h"
 
 #include <maya/MGlobal.h>
 #include <maya/MFnDependencyNode.h>
@@ -32,6 +33,11 @@
 #include <maya/MFnNurbsCurveData.h>
 #include <maya/MFloatVectorArray.h>
 #include <maya/MFnAnimCurve.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MMutexLock.h>
+#include <maya/MThreadPool.h>
+#include <maya/MFloatArray.h>
+#include <maya/MColorArray.h>
 
 #define CORE_CATCH_BEGIN try {
 #define CORE_CATCH_END } \
@@ -51,6 +57,13 @@ struct KLEuler{
   int32_t order;
 };
 
+struct KLEuler_d{
+  double x;
+  double y;
+  double z;
+  int32_t order;
+};
+
 typedef float floatVec[3];
 
 
@@ -223,240 +236,453 @@ void dfgPlugToPort_compound_convertMat44(const MMatrix & matrix, FabricCore::RTV
   MMatrixToMat44(matrix, rtVal);
   CORE_CATCH_END;
 }
-// *****************            Helpers           ***************** // 
 
+// The schema of a compound attribute is resolved once into a layout and
+// reused for every transfer, instead of probing the children's function
+// sets and names each time.
+enum DFGCompoundSlotType
+{
+  DFGCompoundSlot_None,
+  DFGCompoundSlot_UnsupportedNumeric,
+  DFGCompoundSlot_UnsupportedTyped,
+  DFGCompoundSlot_Boolean,
+  DFGCompoundSlot_SInt32,
+  DFGCompoundSlot_Float32,
+  DFGCompoundSlot_Float64,
+  DFGCompoundSlot_Vec3,
+  DFGCompoundSlot_Color,
+  DFGCompoundSlot_String,
+  DFGCompoundSlot_IntArrayData,
+  DFGCompoundSlot_DoubleArrayData,
+  DFGCompoundSlot_VectorArrayData,
+  DFGCompoundSlot_Mat44,
+  DFGCompoundSlot_Compound
+};
 
+struct DFGCompoundSlot
+{
+  DFGCompoundSlotType type;
+  MObject attribute;
+  bool isArray;
+  MString name;
+};
 
-// *****************       DFG Plug to Port       ***************** // 
-void dfgPlugToPort_compound_convertCompound(MFnCompoundAttribute & compound, MDataHandle & handle, FabricCore::RTVal & rtVal)
+struct DFGCompoundLayout
 {
-  std::vector<FabricCore::RTVal> args(5);
+  MObjectHandle attribute;
+  MString name;
+  bool isArray;
+  // compounds with <name>X, <name>Y and <name>Z children
+  // map to a single Vec3 / Euler param as a whole
+  bool isVec3;
+  bool isEuler;
+  std::vector<DFGCompoundSlot> slots;
+};
 
-  CORE_CATCH_BEGIN;
+typedef std::multimap<unsigned int, DFGCompoundLayout> DFGCompoundLayoutMap;
+static DFGCompoundLayoutMap s_compoundLayouts;
+static MMutexLock s_compoundLayoutsLock;
 
-  // treat special cases
-  if(compound.numChildren() == 3)
+static void dfgBuildCompoundLayout(MFnCompoundAttribute & compound, DFGCompoundLayout & layout)
+{
+  layout.name = compound.name();
+  layout.isArray = compound.isArray();
+  layout.isVec3 = false;
+  layout.isEuler = false;
+
+  for(unsigned int i=0;i<compound.numChildren();i++)
   {
-    MString compoundName = compound.name();
-    FabricCore::RTVal compoundNameRTVal = FabricSplice::constructStringRTVal(compoundName.asChar());
+    MFnAttribute child(compound.child(i));
 
-    MFnAttribute x(compound.child(0));
-    MFnAttribute y(compound.child(1));
-    MFnAttribute z(compound.child(2));
+    DFGCompoundSlot slot;
+    slot.type = DFGCompoundSlot_None;
+    slot.attribute = child.object();
+    slot.isArray = child.isArray();
+    slot.name = child.name();
 
-    if(x.name() == compoundName+"X" && y.name() == compoundName+"Y" && z.name() == compoundName+"Z")
+    MStatus attrStatus;
+    MFnNumericAttribute nAttr(slot.attribute, &attrStatus);
+    if(attrStatus == MS::kSuccess)
     {
-      MStatus attrStatus;
-      MFnNumericAttribute nx(x.object(), &attrStatus);
+      switch(nAttr.unitType())
+      {
+        case MFnNumericData::kBoolean: slot.type = DFGCompoundSlot_Boolean; break;
+        case MFnNumericData::kInt:     slot.type = DFGCompoundSlot_SInt32;  break;
+        case MFnNumericData::kFloat:   slot.type = DFGCompoundSlot_Float32; break;
+        case MFnNumericData::kDouble:  slot.type = DFGCompoundSlot_Float64; break;
+        case MFnNumericData::k3Double: slot.type = DFGCompoundSlot_Vec3;    break;
+        case MFnNumericData::k3Float:  slot.type = DFGCompoundSlot_Color;   break;
+        default:                       slot.type = DFGCompoundSlot_UnsupportedNumeric; break;
+      }
+    }
+    else
+    {
+      MFnTypedAttribute tAttr(slot.attribute, &attrStatus);
       if(attrStatus == MS::kSuccess)
       {
-        if(!compound.isArray())
+        switch(tAttr.attrType())
         {
-          MDataHandle xHandle(handle.child(x.object()));
-          MDataHandle yHandle(handle.child(y.object()));
-          MDataHandle zHandle(handle.child(z.object()));
-          args[0] = FabricSplice::constructFloat32RTVal(xHandle.asDouble());
-          args[1] = FabricSplice::constructFloat32RTVal(yHandle.asDouble());
-          args[2] = FabricSplice::constructFloat32RTVal(zHandle.asDouble());
-          FabricCore::RTVal value = FabricSplice::constructRTVal("Vec3", 3, &args[0]);
-          args[0] = compoundNameRTVal;
-          args[1] = value;
-          rtVal = FabricSplice::constructObjectRTVal("Vec3Param", 2, &args[0]);
+          case MFnData::kString:      slot.type = DFGCompoundSlot_String;          break;
+          case MFnData::kIntArray:    slot.type = DFGCompoundSlot_IntArrayData;    break;
+          case MFnData::kDoubleArray: slot.type = DFGCompoundSlot_DoubleArrayData; break;
+          case MFnData::kVectorArray: slot.type = DFGCompoundSlot_VectorArrayData; break;
+          default:                    slot.type = DFGCompoundSlot_UnsupportedTyped; break;
         }
-        else
-        {
-          MArrayDataHandle arrayHandle(handle);
+      }
+      else if(slot.attribute.hasFn(MFn::kMatrixAttribute))
+        slot.type = DFGCompoundSlot_Mat44;
+      else if(slot.attribute.hasFn(MFn::kCompoundAttribute))
+        slot.type = DFGCompoundSlot_Compound;
+    }
+
+    layout.slots.push_back(slot);
+  }
 
-          rtVal = FabricSplice::constructObjectRTVal("Vec3ArrayParam", 1, &compoundNameRTVal);
-          args[0] = FabricSplice::constructUInt32RTVal(arrayHandle.elementCount());
-          rtVal.callMethod("", "resize", 1, &args[0]);
+  if(layout.slots.size() == 3 &&
+    layout.slots[0].name == layout.name+"X" &&
+    layout.slots[1].name == layout.name+"Y" &&
+    layout.slots[2].name == layout.name+"Z")
+  {
+    if(layout.slots[0].attribute.hasFn(MFn::kNumericAttribute))
+      layout.isVec3 = true;
+    else if(layout.slots[0].attribute.hasFn(MFn::kUnitAttribute))
+      layout.isEuler = true;
+  }
+}
 
-          for(unsigned int j=0;j<arrayHandle.elementCount();j++)
-          {
-            MDataHandle elementHandle = arrayHandle.inputValue();
-            MDataHandle xHandle(elementHandle.child(x.object()));
-            MDataHandle yHandle(elementHandle.child(y.object()));
-            MDataHandle zHandle(elementHandle.child(z.object()));
-            args[0] = FabricSplice::constructFloat32RTVal(xHandle.asDouble());
-            args[1] = FabricSplice::constructFloat32RTVal(yHandle.asDouble());
-            args[2] = FabricSplice::constructFloat32RTVal(zHandle.asDouble());
-            FabricCore::RTVal value = FabricSplice::constructRTVal("Vec3", 3, &args[0]);
+// returns a copy of the layout, since the entries of deleted attributes
+// can be dropped by another thread as soon as the lock is released.
+static DFGCompoundLayout dfgGetCompoundLayout(MFnCompoundAttribute & compound)
+{
+  MObject attribute = compound.object();
+  MObjectHandle attributeHandle(attribute);
+  unsigned int hashCode = attributeHandle.hashCode();
+
+  s_compoundLayoutsLock.lock();
+  std::pair<DFGCompoundLayoutMap::iterator, DFGCompoundLayoutMap::iterator> range =
+    s_compoundLayouts.equal_range(hashCode);
+  DFGCompoundLayoutMap::iterator it = range.first;
+  while(it != range.second)
+  {
+    // layouts of deleted (dynamic) attributes are dropped lazily
+    if(!it->second.attribute.isValid())
+      s_compoundLayouts.erase(it++);
+    else if(it->second.attribute == attributeHandle)
+      break;
+    else
+      ++it;
+  }
 
-            args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = value;
-            rtVal.callMethod("", "setValue", 2, &args[0]);
-            arrayHandle.next();
-          }
-        }
+  if(it == range.second)
+  {
+    it = s_compoundLayouts.insert(DFGCompoundLayoutMap::value_type(hashCode, DFGCompoundLayout()));
+    it->second.attribute = attributeHandle;
+    dfgBuildCompoundLayout(compound, it->second);
+  }
 
-        return;
+  DFGCompoundLayout layout = it->second;
+  s_compoundLayoutsLock.unlock();
+  return layout;
+}
+
+// Resizes a <Type>ArrayParam and fills its values from a packed buffer.
+static void dfgSetArrayParamData(FabricCore::RTVal & param, unsigned int numElements, const void * data, size_t elementSize)
+{
+  FabricCore::RTVal numElementsRTVal = FabricSplice::constructUInt32RTVal(numElements);
+  param.callMethod("", "resize", 1, &numElementsRTVal);
+  if(numElements == 0)
+    return;
+
+  FabricCore::RTVal valuesRTVal = param.maybeGetMember("values");
+  FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
+  memcpy(dataRtVal.getData(), data, elementSize * numElements);
+}
+
+// Returns the packed values of a <Type>ArrayParam, valid as long as the param.
+static const void * dfgGetArrayParamData(FabricCore::RTVal & param, unsigned int & numElements)
+{
+  FabricCore::RTVal valuesRTVal = param.maybeGetMember("values");
+  numElements = valuesRTVal.getArraySize();
+  if(numElements == 0)
+    return NULL;
+
+  FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
+  return dataRtVal.getData();
+}
+
+bool dfgSetPolygonMeshPoints(FabricCore::RTVal & rtMesh, MPointArray & mayaPoints)
+{
+  try
+  {
+    std::vector<FabricCore::RTVal> args(2);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
+    args[1] = FabricSplice::constructUInt32RTVal(4); // components
+    rtMesh.callMethod("", "setPointsFromExternalArray_d", 2, &args[0]);
+  }
+  catch(FabricCore::Exception e)
+  {
+    mayaLogErrorFunc(e.getDesc_cstr());
+    return false;
+  }
+  return true;
+}
+
+bool dfgGetPolygonMeshPoints(FabricCore::RTVal & rtMesh, MPointArray & mayaPoints)
+{
+  try
+  {
+    std::vector<FabricCore::RTVal> args(2);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
+    args[1] = FabricSplice::constructUInt32RTVal(4); // components
+    rtMesh.callMethod("", "getPointsAsExternalArray_d", 2, &args[0]);
+  }
+  catch(FabricCore::Exception e)
+  {
+    mayaLogErrorFunc(e.getDesc_cstr());
+    return false;
+  }
+  return true;
+}
+
+bool dfgSetPolygonMeshPoints(FabricCore::RTVal & rtMesh, const float * mayaPoints, unsigned int nbPoints)
+{
+  try
+  {
+    std::vector<FabricCore::RTVal> args(1);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float32", nbPoints * 3, (void*)mayaPoints);
+    rtMesh.callMethod("", "setPointsFromExternalArray", 1, &args[0]);
+  }
+  catch(FabricCore::Exception e)
+  {
+    mayaLogErrorFunc(e.getDesc_cstr());
+    return false;
+  }
+  return true;
+}
+
+bool dfgGetPolygonMeshPoints(FabricCore::RTVal & rtMesh, MFloatPointArray & mayaPoints)
+{
+  unsigned int nbPoints = mayaPoints.length();
+  if(nbPoints == 0)
+    return true;
+
+  try
+  {
+    // the points are fetched as float3 into the front of the array's
+    // float4 buffer and spread out from the back, so that no staging
+    // buffer is needed.
+    float * values = &mayaPoints[0].x;
+    std::vector<FabricCore::RTVal> args(1);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float32", nbPoints * 3, values);
+    rtMesh.callMethod("", "getPointsAsExternalArray", 1, &args[0]);
+
+    for(unsigned int i=nbPoints;i-->0;)
+    {
+      float x = values[i * 3 + 0];
+      float y = values[i * 3 + 1];
+      float z = values[i * 3 + 2];
+      values[i * 4 + 0] = x;
+      values[i * 4 + 1] = y;
+      values[i * 4 + 2] = z;
+      values[i * 4 + 3] = 1.0f;
+    }
+  }
+  catch(FabricCore::Exception e)
+  {
+    mayaLogErrorFunc(e.getDesc_cstr());
+    return false;
+  }
+  return true;
+}
+
+bool dfgGetFullMesh(MDataHandle & geomHandle, MItGeometry & iter, MObject & meshObj)
+{
+  if(geomHandle.type() != MFnData::kMesh)
+    return false;
+  meshObj = geomHandle.asMesh();
+  if(meshObj.isNull())
+    return false;
+  MFnMesh mesh(meshObj);
+  return iter.exactCount() == mesh.numVertices();
+}
+
+// *****************            Helpers           ***************** // 
+
+
+
+// *****************       DFG Plug to Port       ***************** // 
+void dfgPlugToPort_compound_convertCompound(MFnCompoundAttribute & compound, MDataHandle & handle, FabricCore::RTVal & rtVal)
+{
+  std::vector<FabricCore::RTVal> args(5);
+
+  CORE_CATCH_BEGIN;
+
+  DFGCompoundLayout layout = dfgGetCompoundLayout(compound);
+
+  // treat special cases
+  if(layout.isVec3 || layout.isEuler)
+  {
+    FabricCore::RTVal compoundNameRTVal = FabricSplice::constructStringRTVal(layout.name.asChar());
+    MObject x = layout.slots[0].attribute;
+    MObject y = layout.slots[1].attribute;
+    MObject z = layout.slots[2].attribute;
+
+    if(!layout.isArray)
+    {
+      MDataHandle xHandle(handle.child(x));
+      MDataHandle yHandle(handle.child(y));
+      MDataHandle zHandle(handle.child(z));
+      if(layout.isVec3)
+      {
+        args[0] = FabricSplice::constructFloat32RTVal(xHandle.asDouble());
+        args[1] = FabricSplice::constructFloat32RTVal(yHandle.asDouble());
+        args[2] = FabricSplice::constructFloat32RTVal(zHandle.asDouble());
       }
       else
       {
-        MFnUnitAttribute ux(x.object(), &attrStatus);
-        if(attrStatus == MS::kSuccess)
-        {
-          if(!compound.isArray())
-          {
-            MDataHandle xHandle(handle.child(x.object()));
-            MDataHandle yHandle(handle.child(y.object()));
-            MDataHandle zHandle(handle.child(z.object()));
-            args[0] = FabricSplice::constructFloat32RTVal(xHandle.asAngle().as(MAngle::kRadians));
-            args[1] = FabricSplice::constructFloat32RTVal(yHandle.asAngle().as(MAngle::kRadians));
-            args[2] = FabricSplice::constructFloat32RTVal(zHandle.asAngle().as(MAngle::kRadians));
-            FabricCore::RTVal value = FabricSplice::constructRTVal("Euler", 3, &args[0]);
-            args[0] = compoundNameRTVal;
-            args[1] = value;
-            rtVal = FabricSplice::constructObjectRTVal("EulerParam", 2, &args[0]);
-          }
-          else
-          {
-            MArrayDataHandle arrayHandle(handle);
+        args[0] = FabricSplice::constructFloat32RTVal(xHandle.asAngle().as(MAngle::kRadians));
+        args[1] = FabricSplice::constructFloat32RTVal(yHandle.asAngle().as(MAngle::kRadians));
+        args[2] = FabricSplice::constructFloat32RTVal(zHandle.asAngle().as(MAngle::kRadians));
+      }
+      FabricCore::RTVal value = FabricSplice::constructRTVal(layout.isVec3 ? "Vec3" : "Euler", 3, &args[0]);
+      args[0] = compoundNameRTVal;
+      args[1] = value;
+      rtVal = FabricSplice::constructObjectRTVal(layout.isVec3 ? "Vec3Param" : "EulerParam", 2, &args[0]);
+    }
+    else
+    {
+      MArrayDataHandle arrayHandle(handle);
+      unsigned int numElements = arrayHandle.elementCount();
 
-            rtVal = FabricSplice::constructObjectRTVal("EulerArrayParam", 1, &compoundNameRTVal);
-            args[0] = FabricSplice::constructUInt32RTVal(arrayHandle.elementCount());
-            rtVal.callMethod("", "resize", 1, &args[0]);
+      if(layout.isVec3)
+      {
+        std::vector<float> buffer(numElements * 3);
+        for(unsigned int j=0;j<numElements;j++)
+        {
+          MDataHandle elementHandle = arrayHandle.inputValue();
+          buffer[j*3+0] = (float)elementHandle.child(x).asDouble();
+          buffer[j*3+1] = (float)elementHandle.child(y).asDouble();
+          buffer[j*3+2] = (float)elementHandle.child(z).asDouble();
+          arrayHandle.next();
+        }
 
-            for(unsigned int j=0;j<arrayHandle.elementCount();j++)
-            {
-              MDataHandle elementHandle = arrayHandle.inputValue();
-              MDataHandle xHandle(elementHandle.child(x.object()));
-              MDataHandle yHandle(elementHandle.child(y.object()));
-              MDataHandle zHandle(elementHandle.child(z.object()));
-              args[0] = FabricSplice::constructFloat32RTVal(xHandle.asAngle().as(MAngle::kRadians));
-              args[1] = FabricSplice::constructFloat32RTVal(yHandle.asAngle().as(MAngle::kRadians));
-              args[2] = FabricSplice::constructFloat32RTVal(zHandle.asAngle().as(MAngle::kRadians));
-              FabricCore::RTVal value = FabricSplice::constructRTVal("Euler", 3, &args[0]);
-
-              args[0] = FabricSplice::constructUInt32RTVal(j);
-              args[1] = value;
-              rtVal.callMethod("", "setValue", 2, &args[0]);
-              arrayHandle.next();
-            }
-          }
+        rtVal = FabricSplice::constructObjectRTVal("Vec3ArrayParam", 1, &compoundNameRTVal);
+        dfgSetArrayParamData(rtVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(float) * 3);
+      }
+      else
+      {
+        // elements keep the rotation order of a default constructed Euler
+        KLEuler defaultEuler;
+        defaultEuler.x = defaultEuler.y = defaultEuler.z = 0.0f;
+        defaultEuler.order = FabricSplice::constructRTVal("Euler").maybeGetMember("order").maybeGetMember("order").getSInt32();
 
-          return;
+        std::vector<KLEuler> buffer(numElements, defaultEuler);
+        for(unsigned int j=0;j<numElements;j++)
+        {
+          MDataHandle elementHandle = arrayHandle.inputValue();
+          buffer[j].x = (float)elementHandle.child(x).asAngle().as(MAngle::kRadians);
+          buffer[j].y = (float)elementHandle.child(y).asAngle().as(MAngle::kRadians);
+          buffer[j].z = (float)elementHandle.child(z).asAngle().as(MAngle::kRadians);
+          arrayHandle.next();
         }
+
+        rtVal = FabricSplice::constructObjectRTVal("EulerArrayParam", 1, &compoundNameRTVal);
+        dfgSetArrayParamData(rtVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(KLEuler));
       }
     }
+
+    return;
   }
 
-  for(unsigned int i=0;i<compound.numChildren();i++)
+  for(size_t i=0;i<layout.slots.size();i++)
   {
-    MFnAttribute child(compound.child(i));
-    MString childName = child.name();
+    const DFGCompoundSlot & slot = layout.slots[i];
+    const MString & childName = slot.name;
     FabricCore::RTVal childNameRTVal = FabricSplice::constructStringRTVal(childName.asChar());
     FabricCore::RTVal childRTVal;
-    MStatus attrStatus;
 
-    MFnNumericAttribute nAttr(child.object(), &attrStatus);
-    if(attrStatus == MS::kSuccess)
+    switch(slot.type)
     {
-      if(nAttr.unitType() == MFnNumericData::kBoolean)
+      case DFGCompoundSlot_Boolean:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           args[0] = childNameRTVal;
           args[1] = FabricSplice::constructBooleanRTVal(childHandle.asBool());
           childRTVal = FabricSplice::constructObjectRTVal("BooleanParam", 2, &args[0]);
         }
         else
         {
-          MArrayDataHandle childHandle(handle.child(child.object()));
-          childRTVal = FabricSplice::constructObjectRTVal("BooleanArrayParam", 1, &childNameRTVal);
-          args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-          childRTVal.callMethod("", "resize", 1, &args[0]);
-
-          for(unsigned int j=0;j<childHandle.elementCount();j++)
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          unsigned int numElements = childHandle.elementCount();
+          std::vector<uint8_t> buffer(numElements);
+          for(unsigned int j=0;j<numElements;j++)
           {
-            args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = FabricSplice::constructBooleanRTVal(childHandle.inputValue().asBool());
-            childRTVal.callMethod("", "setValue", 2, &args[0]);
+            buffer[j] = childHandle.inputValue().asBool() ? 1 : 0;
             childHandle.next();
           }
+          childRTVal = FabricSplice::constructObjectRTVal("BooleanArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(uint8_t));
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::kInt)
+      case DFGCompoundSlot_SInt32:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           args[0] = childNameRTVal;
           args[1] = FabricSplice::constructSInt32RTVal(childHandle.asInt());
           childRTVal = FabricSplice::constructObjectRTVal("SInt32Param", 2, &args[0]);
         }
         else
         {
-          MArrayDataHandle childHandle(handle.child(child.object()));
-          childRTVal = FabricSplice::constructObjectRTVal("SInt32ArrayParam", 1, &childNameRTVal);
-          args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-          childRTVal.callMethod("", "resize", 1, &args[0]);
-
-          for(unsigned int j=0;j<childHandle.elementCount();j++)
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          unsigned int numElements = childHandle.elementCount();
+          std::vector<int32_t> buffer(numElements);
+          for(unsigned int j=0;j<numElements;j++)
           {
-            args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = FabricSplice::constructSInt32RTVal(childHandle.inputValue().asInt());
-            childRTVal.callMethod("", "setValue", 2, &args[0]);
+            buffer[j] = childHandle.inputValue().asInt();
             childHandle.next();
           }
+          childRTVal = FabricSplice::constructObjectRTVal("SInt32ArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(int32_t));
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::kFloat)
+      case DFGCompoundSlot_Float32:
+      case DFGCompoundSlot_Float64:
       {
-        if(!nAttr.isArray())
+        bool isFloat = slot.type == DFGCompoundSlot_Float32;
+        if(!slot.isArray)
         {
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           args[0] = childNameRTVal;
-          args[1] = FabricSplice::constructFloat64RTVal(childHandle.asFloat());
+          args[1] = FabricSplice::constructFloat64RTVal(isFloat ? childHandle.asFloat() : childHandle.asDouble());
           childRTVal = FabricSplice::constructObjectRTVal("Float64Param", 2, &args[0]);
         }
         else
         {
-          MArrayDataHandle childHandle(handle.child(child.object()));
-          childRTVal = FabricSplice::constructObjectRTVal("Float64ArrayParam", 1, &childNameRTVal);
-          args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-          childRTVal.callMethod("", "resize", 1, &args[0]);
-
-          for(unsigned int j=0;j<childHandle.elementCount();j++)
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          unsigned int numElements = childHandle.elementCount();
+          std::vector<double> buffer(numElements);
+          for(unsigned int j=0;j<numElements;j++)
           {
-            args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = FabricSplice::constructFloat64RTVal(childHandle.inputValue().asFloat());
-            childRTVal.callMethod("", "setValue", 2, &args[0]);
+            MDataHandle elementHandle = childHandle.inputValue();
+            buffer[j] = isFloat ? elementHandle.asFloat() : elementHandle.asDouble();
             childHandle.next();
           }
-        }
-      }
-      else if(nAttr.unitType() == MFnNumericData::kDouble)
-      {
-        if(!nAttr.isArray())
-        {
-          MDataHandle childHandle(handle.child(child.object()));
-          args[0] = childNameRTVal;
-          args[1] = FabricSplice::constructFloat64RTVal(childHandle.asDouble());
-          childRTVal = FabricSplice::constructObjectRTVal("Float64Param", 2, &args[0]);
-        }
-        else
-        {
-          MArrayDataHandle childHandle(handle.child(child.object()));
           childRTVal = FabricSplice::constructObjectRTVal("Float64ArrayParam", 1, &childNameRTVal);
-          args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-          childRTVal.callMethod("", "resize", 1, &args[0]);
-
-          for(unsigned int j=0;j<childHandle.elementCount();j++)
-          {
-            args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = FabricSplice::constructFloat64RTVal(childHandle.inputValue().asDouble());
-            childRTVal.callMethod("", "setValue", 2, &args[0]);
-            childHandle.next();
-          }
+          dfgSetArrayParamData(childRTVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(double));
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::k3Double) // vec3
+      case DFGCompoundSlot_Vec3:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           args[0] = childNameRTVal;
           args[1] = FabricSplice::constructRTVal("Vec3", 0, 0);
           MFloatVector v = childHandle.asFloatVector();
@@ -467,29 +693,27 @@ void dfgPlugToPort_compound_convertCompound(MFnCompoundAttribute & compound, MDa
         }
         else
         {
-          MArrayDataHandle childHandle(handle.child(child.object()));
-          childRTVal = FabricSplice::constructObjectRTVal("Vec3ArrayParam", 1, &childNameRTVal);
-          args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-          childRTVal.callMethod("", "resize", 1, &args[0]);
-
-          for(unsigned int j=0;j<childHandle.elementCount();j++)
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          unsigned int numElements = childHandle.elementCount();
+          std::vector<float> buffer(numElements * 3);
+          for(unsigned int j=0;j<numElements;j++)
           {
-            args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = FabricSplice::constructRTVal("Vec3", 0, 0);
             MFloatVector v = childHandle.inputValue().asFloatVector();
-            args[1].setMember("x", FabricSplice::constructFloat64RTVal(v.x));
-            args[1].setMember("y", FabricSplice::constructFloat64RTVal(v.y));
-            args[1].setMember("z", FabricSplice::constructFloat64RTVal(v.z));
-            childRTVal.callMethod("", "setValue", 2, &args[0]);
+            buffer[j*3+0] = v.x;
+            buffer[j*3+1] = v.y;
+            buffer[j*3+2] = v.z;
             childHandle.next();
           }
+          childRTVal = FabricSplice::constructObjectRTVal("Vec3ArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(float) * 3);
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::k3Float) // color
+      case DFGCompoundSlot_Color:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           args[0] = childNameRTVal;
           args[1] = FabricSplice::constructRTVal("Color", 0, 0);
           MFloatVector v = childHandle.asFloatVector();
@@ -501,178 +725,151 @@ void dfgPlugToPort_compound_convertCompound(MFnCompoundAttribute & compound, MDa
         }
         else
         {
-          MArrayDataHandle childHandle(handle.child(child.object()));
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          unsigned int numElements = childHandle.elementCount();
+          std::vector<float> buffer(numElements * 4, 1.0f);
+          for(unsigned int j=0;j<numElements;j++)
+          {
+            MFloatVector v = childHandle.inputValue().asFloatVector();
+            buffer[j*4+0] = v.x;
+            buffer[j*4+1] = v.y;
+            buffer[j*4+2] = v.z;
+            childHandle.next();
+          }
           childRTVal = FabricSplice::constructObjectRTVal("ColorArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(float) * 4);
+        }
+        break;
+      }
+      case DFGCompoundSlot_String:
+      {
+        if(!slot.isArray)
+        {
+          MDataHandle childHandle(handle.child(slot.attribute));
+          args[0] = childNameRTVal;
+          args[1] = FabricSplice::constructStringRTVal(childHandle.asString().asChar());
+          childRTVal = FabricSplice::constructObjectRTVal("StringParam", 2, &args[0]);
+        }
+        else
+        {
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          childRTVal = FabricSplice::constructObjectRTVal("StringArrayParam", 1, &childNameRTVal);
           args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
           childRTVal.callMethod("", "resize", 1, &args[0]);
 
           for(unsigned int j=0;j<childHandle.elementCount();j++)
           {
             args[0] = FabricSplice::constructUInt32RTVal(j);
-            args[1] = FabricSplice::constructRTVal("Color", 0, 0);
-            MFloatVector v = childHandle.inputValue().asFloatVector();
-            args[1].setMember("r", FabricSplice::constructFloat64RTVal(v.x));
-            args[1].setMember("g", FabricSplice::constructFloat64RTVal(v.y));
-            args[1].setMember("b", FabricSplice::constructFloat64RTVal(v.z));
-            args[1].setMember("a", FabricSplice::constructFloat64RTVal(1.0));
+            args[1] = FabricSplice::constructStringRTVal(childHandle.inputValue().asString().asChar());
             childRTVal.callMethod("", "setValue", 2, &args[0]);
             childHandle.next();
           }
         }
+        break;
       }
-      else
-      {
-        mayaLogErrorFunc("Unsupported numeric attribute '"+childName+"'.");
-        return;
-      }
-    }
-    else
-    {
-      MFnTypedAttribute tAttr(child.object(), &attrStatus);
-      if(attrStatus == MS::kSuccess)
+      case DFGCompoundSlot_IntArrayData:
       {
-        if(tAttr.attrType() == MFnData::kString)
+        if(!slot.isArray)
         {
-          if(!tAttr.isArray())
-          {
-            MDataHandle childHandle(handle.child(child.object()));
-            args[0] = childNameRTVal;
-            args[1] = FabricSplice::constructStringRTVal(childHandle.asString().asChar());
-            childRTVal = FabricSplice::constructObjectRTVal("StringParam", 2, &args[0]);
-          }
-          else
-          {
-            MArrayDataHandle childHandle(handle.child(child.object()));
-            childRTVal = FabricSplice::constructObjectRTVal("StringArrayParam", 1, &childNameRTVal);
-            args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-            childRTVal.callMethod("", "resize", 1, &args[0]);
-
-            for(unsigned int j=0;j<childHandle.elementCount();j++)
-            {
-              args[0] = FabricSplice::constructUInt32RTVal(j);
-              args[1] = FabricSplice::constructStringRTVal(childHandle.inputValue().asString().asChar());
-              childRTVal.callMethod("", "setValue", 2, &args[0]);
-              childHandle.next();
-            }
-          }
+          MDataHandle childHandle(handle.child(slot.attribute));
+          MIntArray arrayValues = MFnIntArrayData(childHandle.data()).array();
+          unsigned int numArrayValues = arrayValues.length();
+          childRTVal = FabricSplice::constructObjectRTVal("SInt32ArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numArrayValues, numArrayValues > 0 ? &arrayValues[0] : NULL, sizeof(int32_t));
         }
-        else if(tAttr.attrType() == MFnData::kIntArray)
+        else
         {
-          if(!tAttr.isArray())
-          {
-            args[0] = childNameRTVal;
-            childRTVal = FabricSplice::constructObjectRTVal("SInt32ArrayParam", 1, &args[0]);
-
-            MIntArray arrayValues = MFnIntArrayData(handle.data()).array();
-            unsigned int numArrayValues = arrayValues.length();
-            args[0] = FabricSplice::constructUInt32RTVal(numArrayValues);
-            childRTVal.callMethod("", "resize", 1, &args[0]);
-
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
-            void * data = dataRtVal.getData();
-            memcpy(data, &arrayValues[0], sizeof(int32_t) * numArrayValues);
-          }
-          else
-          {
-            mayaLogErrorFunc("Arrays of MFnData::kIntArray are not supported for '"+childName+"'.");
-          }
+          mayaLogErrorFunc("Arrays of MFnData::kIntArray are not supported for '"+childName+"'.");
         }
-        else if(tAttr.attrType() == MFnData::kDoubleArray)
+        break;
+      }
+      case DFGCompoundSlot_DoubleArrayData:
+      {
+        if(!slot.isArray)
         {
-          if(!tAttr.isArray())
-          {
-            args[0] = childNameRTVal;
-            childRTVal = FabricSplice::constructObjectRTVal("Float64ArrayParam", 1, &args[0]);
-
-            MDoubleArray arrayValues = MFnDoubleArrayData(handle.data()).array();
-            unsigned int numArrayValues = arrayValues.length();
-            args[0] = FabricSplice::constructUInt32RTVal(numArrayValues);
-            childRTVal.callMethod("", "resize", 1, &args[0]);
-
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
-            void * data = dataRtVal.getData();
-            memcpy(data, &arrayValues[0], sizeof(double) * numArrayValues);
-          }
-          else
-          {
-            mayaLogErrorFunc("Arrays of MFnData::kDoubleArray are not supported for '"+childName+"'.");
-          }
+          MDataHandle childHandle(handle.child(slot.attribute));
+          MDoubleArray arrayValues = MFnDoubleArrayData(childHandle.data()).array();
+          unsigned int numArrayValues = arrayValues.length();
+          childRTVal = FabricSplice::constructObjectRTVal("Float64ArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numArrayValues, numArrayValues > 0 ? &arrayValues[0] : NULL, sizeof(double));
+        }
+        else
+        {
+          mayaLogErrorFunc("Arrays of MFnData::kDoubleArray are not supported for '"+childName+"'.");
         }
-        else if(tAttr.attrType() == MFnData::kVectorArray)
+        break;
+      }
+      case DFGCompoundSlot_VectorArrayData:
+      {
+        if(!slot.isArray)
         {
-          if(!tAttr.isArray())
-          {
-            args[0] = childNameRTVal;
-            childRTVal = FabricSplice::constructObjectRTVal("Vec3ArrayParam", 1, &args[0]);
-
-            MVectorArray arrayValues = MFnVectorArrayData(handle.data()).array();
-            unsigned int numArrayValues = arrayValues.length();
-            args[0] = FabricSplice::constructUInt32RTVal(numArrayValues);
-            childRTVal.callMethod("", "resize", 1, &args[0]);
-
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
-            float * data = (float*)dataRtVal.getData();
-            arrayValues.get((floatVec*)data);
-          }
-          else
-          {
-            mayaLogErrorFunc("Arrays of MFnData::kVectorArray are not supported for '"+childName+"'.");
-          }
+          MDataHandle childHandle(handle.child(slot.attribute));
+          MVectorArray arrayValues = MFnVectorArrayData(childHandle.data()).array();
+          unsigned int numArrayValues = arrayValues.length();
+          std::vector<float> buffer(numArrayValues * 3);
+          if(numArrayValues > 0)
+            dfgNarrowFloat64ToFloat32(&arrayValues[0].x, &buffer[0], numArrayValues * 3);
+          childRTVal = FabricSplice::constructObjectRTVal("Vec3ArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numArrayValues, numArrayValues > 0 ? &buffer[0] : NULL, sizeof(float) * 3);
         }
         else
         {
-          mayaLogErrorFunc("Unsupported typed attribute '"+childName+"'.");
-          return;
+          mayaLogErrorFunc("Arrays of MFnData::kVectorArray are not supported for '"+childName+"'.");
         }
+        break;
       }
-      else
+      case DFGCompoundSlot_Mat44:
       {
-        MFnMatrixAttribute mAttr(child.object(), &attrStatus);
-        if(attrStatus == MS::kSuccess)
+        if(!slot.isArray)
         {
-          if(!mAttr.isArray())
-          {
-            MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
 
-            childRTVal = FabricSplice::constructObjectRTVal("Mat44Param", 1, &childNameRTVal);
-            FabricCore::RTVal matrixRTVal;
-            dfgPlugToPort_compound_convertMat44(childHandle.asMatrix(), matrixRTVal);
-            childRTVal.callMethod("", "setValue", 1, &matrixRTVal);
-          }
-          else
-          {
-            MArrayDataHandle childHandle(handle.child(child.object()));
-            childRTVal = FabricSplice::constructObjectRTVal("Mat44ArrayParam", 1, &childNameRTVal);
-            args[0] = FabricSplice::constructUInt32RTVal(childHandle.elementCount());
-            childRTVal.callMethod("", "resize", 1, &args[0]);
-
-            for(unsigned int j=0;j<childHandle.elementCount();j++)
-            {
-              args[0] = FabricSplice::constructUInt32RTVal(j);
-              dfgPlugToPort_compound_convertMat44(childHandle.inputValue().asMatrix(), args[1]);
-              childRTVal.callMethod("", "setValue", 2, &args[0]);
-              childHandle.next();
-            }
-          }
+          childRTVal = FabricSplice::constructObjectRTVal("Mat44Param", 1, &childNameRTVal);
+          FabricCore::RTVal matrixRTVal;
+          dfgPlugToPort_compound_convertMat44(childHandle.asMatrix(), matrixRTVal);
+          childRTVal.callMethod("", "setValue", 1, &matrixRTVal);
         }
         else
         {
-          MFnCompoundAttribute cAttr(child.object(), &attrStatus);
-          if(attrStatus == MS::kSuccess)
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          unsigned int numElements = childHandle.elementCount();
+          std::vector<double> gathered(numElements * 16);
+          for(unsigned int j=0;j<numElements;j++)
           {
-            MFnCompoundAttribute cAttr(compound.child(i));
-            if(!cAttr.isArray())
-            {
-              MDataHandle childHandle(handle.child(child.object()));
-              childRTVal = FabricSplice::constructObjectRTVal("CompoundParam", 1, &childNameRTVal);
-              dfgPlugToPort_compound_convertCompound(cAttr, childHandle, childRTVal);
-            }
+            memcpy(&gathered[j * 16], childHandle.inputValue().asMatrix().matrix, sizeof(double) * 16);
+            childHandle.next();
           }
+          std::vector<float> buffer(numElements * 16);
+          if(numElements > 0)
+            dfgTransposeMat44(&gathered[0], &buffer[0], numElements);
+          childRTVal = FabricSplice::constructObjectRTVal("Mat44ArrayParam", 1, &childNameRTVal);
+          dfgSetArrayParamData(childRTVal, numElements, numElements > 0 ? &buffer[0] : NULL, sizeof(float) * 16);
         }
+        break;
       }
+      case DFGCompoundSlot_Compound:
+      {
+        if(!slot.isArray)
+        {
+          MFnCompoundAttribute cAttr(slot.attribute);
+          MDataHandle childHandle(handle.child(slot.attribute));
+          childRTVal = FabricSplice::constructObjectRTVal("CompoundParam", 1, &childNameRTVal);
+          dfgPlugToPort_compound_convertCompound(cAttr, childHandle, childRTVal);
+        }
+        break;
+      }
+      case DFGCompoundSlot_UnsupportedNumeric:
+      {
+        mayaLogErrorFunc("Unsupported numeric attribute '"+childName+"'.");
+        return;
+      }
+      case DFGCompoundSlot_UnsupportedTyped:
+      {
+        mayaLogErrorFunc("Unsupported typed attribute '"+childName+"'.");
+        return;
+      }
+      default:
+        break;
     }
 
     if(childRTVal.isValid())
@@ -960,16 +1157,35 @@ void dfgPlugToPort_integer(
     // bool isNativeArray = FTL::CStrRef(binding.getExec().getExecPortMetadata(argName, "nativeArray")) == "true";
     if(handle.type() == MFnData::kIntArray) { // || isNativeArray) {
       MIntArray arrayValues = MFnIntArrayData(handle.data()).array();
-
       unsigned int numElements = arrayValues.length();
-      std::vector<int32_t> buffer(numElements);
-      int32_t * values = &buffer[0];
 
-      for(unsigned int i = 0; i < numElements; ++i) {
-        values[i] = (int32_t)arrayValues[i];
+      FTL::CStrRef resolvedType = argTypeName;
+      if(resolvedType == FTL_STR("SInt32[]") || resolvedType == FTL_STR("UInt32[]"))
+      {
+        // same layout as Maya's storage, hand it over without a copy
+        setRawCB(getSetUD, numElements > 0 ? &arrayValues[0] : NULL, elementDataSize * numElements);
+      }
+      else if(resolvedType == FTL_STR("SInt64[]") || resolvedType == FTL_STR("UInt64[]"))
+      {
+        std::vector<int64_t> buffer(numElements);
+        for(unsigned int i = 0; i < numElements; ++i)
+          buffer[i] = (int64_t)arrayValues[i];
+        setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, sizeof(int64_t) * numElements);
+      }
+      else if(resolvedType == FTL_STR("SInt16[]") || resolvedType == FTL_STR("UInt16[]"))
+      {
+        std::vector<int16_t> buffer(numElements);
+        for(unsigned int i = 0; i < numElements; ++i)
+          buffer[i] = (int16_t)arrayValues[i];
+        setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, sizeof(int16_t) * numElements);
+      }
+      else if(resolvedType == FTL_STR("SInt8[]") || resolvedType == FTL_STR("UInt8[]"))
+      {
+        std::vector<int8_t> buffer(numElements);
+        for(unsigned int i = 0; i < numElements; ++i)
+          buffer[i] = (int8_t)arrayValues[i];
+        setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, sizeof(int8_t) * numElements);
       }
-
-      setRawCB(getSetUD, values, elementDataSize * numElements);
     }else{
 
       FTL::CStrRef resolvedType = argTypeName;
@@ -1031,7 +1247,7 @@ void dfgPlugToPort_scalar(
   if (isDouble)
     elementDataSize = sizeof(double);
 
-  uint64_t currentNumElements = argRawDataSize / elementDataSize;
+  // uint64_t currentNumElements = argRawDataSize / elementDataSize;
 
   // FTL::CStrRef scalarUnit = binding.getExec().getExecPortMetadata(argName, "scalarUnit");
   if(plug.isArray()){
@@ -1076,25 +1292,21 @@ void dfgPlugToPort_scalar(
     FTL::AutoProfilingPauseEvent pauseBracket(bracket);
     MDataHandle handle = data.inputValue(plug);
     pauseBracket.resume();
-    if(currentNumElements > 1){
+    if(handle.type() == MFnData::kDoubleArray){
       MDoubleArray arrayValues = MFnDoubleArrayData(handle.data()).array();
       unsigned int numElements = arrayValues.length();
   
       if (isDouble)
       {
-        std::vector<float> buffer(numElements);
-        float * values = &buffer[0];
-        for (unsigned int i = 0; i < numElements; ++i)
-          values[i] = (float)arrayValues[i];
-        setRawCB(getSetUD, values, elementDataSize * numElements);
+        // same layout as Maya's storage, hand it over without a copy
+        setRawCB(getSetUD, numElements > 0 ? &arrayValues[0] : NULL, elementDataSize * numElements);
       }
       else
       {
-        std::vector<double> buffer(numElements);
-        double * values = &buffer[0];
-        for (unsigned int i = 0; i < numElements; ++i)
-          values[i] = arrayValues[i];
-        setRawCB(getSetUD, values, elementDataSize * numElements);
+        std::vector<float> buffer(numElements);
+        if(numElements > 0)
+          dfgNarrowFloat64ToFloat32(&arrayValues[0], &buffer[0], numElements);
+        setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, elementDataSize * numElements);
       }
     }
     else
@@ -1202,27 +1414,30 @@ void dfgPlugToPort_color(
     pauseBracket.resume();
     unsigned int numElements = arrayHandle.elementCount();
 
-    std::vector<float> buffer(numElements * 4);
+    std::vector<float> buffer(numElements * 4, 1.0f);
     float * values = &buffer[0];
 
-    unsigned int offset = 0;
+    // gather the Maya colors first, then pack them into RGBA in one pass
+    std::vector<float> gathered;
+    std::vector<double> gathered_d;
     for(unsigned int i = 0; i < numElements; ++i){
       arrayHandle.jumpToArrayElement(i);
       MDataHandle handle = arrayHandle.inputValue();
 
       if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
-        MFloatVector v = handle.asFloatVector();
-        values[offset++] = v.x;
-        values[offset++] = v.y;
-        values[offset++] = v.z;
+        if(gathered.empty())
+          gathered.resize(numElements * 3);
+        memcpy(&gathered[i * 3], handle.asFloat3(), sizeof(float) * 3);
       } else{
-        MVector v = handle.asVector();
-        values[offset++] = (float)v.x;
-        values[offset++] = (float)v.y;
-        values[offset++] = (float)v.z;
+        if(gathered_d.empty())
+          gathered_d.resize(numElements * 3);
+        memcpy(&gathered_d[i * 3], handle.asDouble3(), sizeof(double) * 3);
       }
-      values[offset++] = 1.0f;
     }
+    if(!gathered.empty())
+      dfgPackFloat32x3ToFloat32x4(&gathered[0], values, numElements);
+    else if(!gathered_d.empty())
+      dfgPackFloat64x3ToFloat32x4(&gathered_d[0], values, numElements);
 
     setRawCB(getSetUD, values, elementDataSize * numElements);
   }
@@ -1231,6 +1446,21 @@ void dfgPlugToPort_color(
     MDataHandle handle = data.inputValue(plug);
     pauseBracket.resume();
 
+    if(handle.type() == MFnData::kVectorArray){
+      MVectorArray arrayValues = MFnVectorArrayData(handle.data()).array();
+      unsigned int numElements = arrayValues.length();
+
+      std::vector<float> buffer(numElements * 4, 1.0f);
+      for(unsigned int i = 0; i < numElements; ++i){
+        buffer[i * 4 + 0] = (float)arrayValues[i].x;
+        buffer[i * 4 + 1] = (float)arrayValues[i].y;
+        buffer[i * 4 + 2] = (float)arrayValues[i].z;
+      }
+
+      setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, elementDataSize * numElements);
+      return;
+    }
+
     float values[4];
     if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
       MFloatVector v = handle.asFloatVector();
@@ -1444,60 +1674,47 @@ void dfgPlugToPort_vec3(
     std::vector<float> buffer(numElements * 3);
     float * values = &buffer[0];
 
-    unsigned int offset = 0;
+    // gather double precision elements first and narrow them in one pass
+    std::vector<double> gathered;
     for(unsigned int i = 0; i < numElements; ++i){
       arrayHandle.jumpToArrayElement(i);
       MDataHandle handle = arrayHandle.inputValue();
       if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
-        const float3& mayaVec = handle.asFloat3();
-        values[offset++] = (float)mayaVec[0];
-        values[offset++] = (float)mayaVec[1];
-        values[offset++] = (float)mayaVec[2];
+        memcpy(&values[i * 3], handle.asFloat3(), sizeof(float) * 3);
       } else {
-        const double3& mayaVec = handle.asDouble3();
-        values[offset++] = (float)mayaVec[0];
-        values[offset++] = (float)mayaVec[1];
-        values[offset++] = (float)mayaVec[2];
+        if(gathered.empty())
+          gathered.resize(numElements * 3);
+        memcpy(&gathered[i * 3], handle.asDouble3(), sizeof(double) * 3);
       }
     }
+    if(!gathered.empty())
+      dfgNarrowFloat64ToFloat32(&gathered[0], values, numElements * 3);
 
     setRawCB(getSetUD, values, elementDataSize * numElements);
   }else{
     FTL::AutoProfilingPauseEvent pauseBracket(bracket);
     MDataHandle handle = data.inputValue(plug);
     pauseBracket.resume();
-    // todo: reenable the native array support
-    // bool isNativeArray = FTL::CStrRef(binding.getExec().getExecPortMetadata(argName, "nativeArray")) == "true";
-    if(handle.type() == MFnData::kVectorArray) { // || isNativeArray){
+    if(handle.type() == MFnData::kVectorArray) {
       MVectorArray arrayValues = MFnVectorArrayData(handle.data()).array();
       unsigned int numElements = arrayValues.length();
 
+      // MVector is three packed doubles, narrow the whole array in one go
       std::vector<float> buffer(numElements * 3);
-      float * values = &buffer[0];
+      if(numElements > 0)
+        dfgNarrowFloat64ToFloat32(&arrayValues[0].x, &buffer[0], numElements * 3);
 
-      size_t offset = 0;
-      for(unsigned int i = 0; i < numElements; ++i){
-        values[offset++] = (float)arrayValues[i].x;
-        values[offset++] = (float)arrayValues[i].y;
-        values[offset++] = (float)arrayValues[i].z;
-      }
-
-      setRawCB(getSetUD, values, elementDataSize * numElements);
+      setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, elementDataSize * numElements);
     }else if(handle.type() == MFnData::kPointArray){
       MPointArray arrayValues = MFnPointArrayData(handle.data()).array();
       unsigned int numElements = arrayValues.length();
 
+      // MPoint is four packed doubles, drop w and narrow in one go
       std::vector<float> buffer(numElements * 3);
-      float * values = &buffer[0];
-
-      size_t offset = 0;
-      for(unsigned int i = 0; i < numElements; ++i){
-        values[offset++] = (float)arrayValues[i].x;
-        values[offset++] = (float)arrayValues[i].y;
-        values[offset++] = (float)arrayValues[i].z;
-      }
+      if(numElements > 0)
+        dfgUnpackFloat64x4ToFloat32x3(&arrayValues[0].x, &buffer[0], numElements);
 
-      setRawCB(getSetUD, values, elementDataSize * numElements);
+      setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, elementDataSize * numElements);
     }else{
       float values[3];
       if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
@@ -1560,34 +1777,24 @@ void dfgPlugToPort_vec3_float64(
     MDataHandle handle = data.inputValue(plug);
     pauseBracket.resume();
 
-    if(handle.numericType() != MFnNumericData::k3Double && handle.numericType() != MFnNumericData::kDouble)
-      return;
-
     if(handle.type() == MFnData::kVectorArray) 
     { 
+      // MVector is three packed doubles, same layout as Vec3_d
       MVectorArray arrayValues = MFnVectorArrayData(handle.data()).array();
-      std::vector<double> buffer(arrayValues.length() * elementSize);
-      for(unsigned int i = 0; i < arrayValues.length(); ++i)
-      {
-        buffer[elementSize*i + 0] = arrayValues[i].x;
-        buffer[elementSize*i + 1] = arrayValues[i].y;
-        buffer[elementSize*i + 2] = arrayValues[i].z;
-      }
-      setRawCB(getSetUD, &buffer[0], elementDataSize * arrayValues.length());
+      unsigned int numElements = arrayValues.length();
+      setRawCB(getSetUD, numElements > 0 ? &arrayValues[0].x : NULL, elementDataSize * numElements);
     }
     else if(handle.type() == MFnData::kPointArray)
     {
+      // MPoint is four packed doubles, drop w in one go
       MPointArray arrayValues = MFnPointArrayData(handle.data()).array();
-      std::vector<double> buffer(arrayValues.length() * elementSize);
-      for(unsigned int i = 0; i < arrayValues.length(); ++i)
-      {
-        buffer[elementSize*i + 0] = arrayValues[i].x;
-        buffer[elementSize*i + 1] = arrayValues[i].y;
-        buffer[elementSize*i + 2] = arrayValues[i].z;
-      }
-      setRawCB(getSetUD, &buffer[0], elementDataSize * arrayValues.length());
+      unsigned int numElements = arrayValues.length();
+      std::vector<double> buffer(numElements * elementSize);
+      if(numElements > 0)
+        dfgUnpackFloat64x4ToFloat64x3(&arrayValues[0].x, &buffer[0], numElements);
+      setRawCB(getSetUD, numElements > 0 ? &buffer[0] : NULL, elementDataSize * numElements);
     }
-    else
+    else if(handle.numericType() == MFnNumericData::k3Double || handle.numericType() == MFnNumericData::kDouble)
     {
       const double3& mayaVec = handle.asDouble3();
       setRawCB(getSetUD, mayaVec, elementDataSize);
@@ -1809,29 +2016,34 @@ void dfgPlugToPort_euler(
     pauseBracket.resume();
 
     unsigned int elements = arrayHandle.elementCount();
-    FabricCore::RTVal arrayVal = FabricSplice::constructVariableArrayRTVal("Euler");
-    FabricCore::RTVal euler = FabricSplice::constructRTVal("Euler");
-    FabricCore::RTVal arraySizeVal = FabricSplice::constructUInt32RTVal(elements);
-    arrayVal.callMethod("", "resize", 1, &arraySizeVal);
+
+    // gather the angles first, then pack them into the KL layout in one pass
+    std::vector<double> angles(elements * 3);
     for(unsigned int i = 0; i < elements; ++i){
       arrayHandle.jumpToArrayElement(i);
       MDataHandle handle = arrayHandle.inputValue();
 
       if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
         const float3& mayaVec = handle.asFloat3();
-        euler.setMember("x", FabricSplice::constructFloat64RTVal(mayaVec[0]));
-        euler.setMember("y", FabricSplice::constructFloat64RTVal(mayaVec[1]));
-        euler.setMember("z", FabricSplice::constructFloat64RTVal(mayaVec[2]));
+        angles[i * 3 + 0] = mayaVec[0];
+        angles[i * 3 + 1] = mayaVec[1];
+        angles[i * 3 + 2] = mayaVec[2];
       } else{
-        const double3& mayaVec = handle.asDouble3();
-        euler.setMember("x", FabricSplice::constructFloat64RTVal(mayaVec[0]));
-        euler.setMember("y", FabricSplice::constructFloat64RTVal(mayaVec[1]));
-        euler.setMember("z", FabricSplice::constructFloat64RTVal(mayaVec[2]));
+        memcpy(&angles[i * 3], handle.asDouble3(), sizeof(double) * 3);
       }
-      arrayVal.setArrayElement(i, euler);
     }
 
-    setCB(getSetUD, arrayVal.getFECRTValRef());
+    // elements keep the rotation order of a default constructed Euler
+    FabricCore::RTVal euler = FabricSplice::constructRTVal("Euler");
+    KLEuler defaultEuler;
+    defaultEuler.x = defaultEuler.y = defaultEuler.z = 0.0f;
+    defaultEuler.order = euler.maybeGetMember("order").maybeGetMember("order").getSInt32();
+
+    std::vector<KLEuler> buffer(elements, defaultEuler);
+    if(elements > 0)
+      dfgPackFloat64x3ToFloat32x4(&angles[0], (float *)&buffer[0], elements);
+
+    setRawCB(getSetUD, elements > 0 ? &buffer[0] : NULL, sizeof(KLEuler) * elements);
   }
   else {
     FabricCore::RTVal rtVal = getCB(getSetUD);
@@ -1884,29 +2096,32 @@ void dfgPlugToPort_euler_float64(
     pauseBracket.resume();
 
     unsigned int elements = arrayHandle.elementCount();
-    FabricCore::RTVal arrayVal = FabricSplice::constructVariableArrayRTVal("Euler_d");
+
+    // elements keep the rotation order of a default constructed Euler_d
     FabricCore::RTVal euler = FabricSplice::constructRTVal("Euler_d");
-    FabricCore::RTVal arraySizeVal = FabricSplice::constructUInt32RTVal(elements);
-    arrayVal.callMethod("", "resize", 1, &arraySizeVal);
+    KLEuler_d defaultEuler;
+    defaultEuler.x = defaultEuler.y = defaultEuler.z = 0.0;
+    defaultEuler.order = euler.maybeGetMember("order").maybeGetMember("order").getSInt32();
+
+    std::vector<KLEuler_d> buffer(elements, defaultEuler);
     for(unsigned int i = 0; i < elements; ++i){
       arrayHandle.jumpToArrayElement(i);
       MDataHandle handle = arrayHandle.inputValue();
 
       if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
         const float3& mayaVec = handle.asFloat3();
-        euler.setMember("x", FabricSplice::constructFloat64RTVal(mayaVec[0]));
-        euler.setMember("y", FabricSplice::constructFloat64RTVal(mayaVec[1]));
-        euler.setMember("z", FabricSplice::constructFloat64RTVal(mayaVec[2]));
+        buffer[i].x = mayaVec[0];
+        buffer[i].y = mayaVec[1];
+        buffer[i].z = mayaVec[2];
       } else{
         const double3& mayaVec = handle.asDouble3();
-        euler.setMember("x", FabricSplice::constructFloat64RTVal(mayaVec[0]));
-        euler.setMember("y", FabricSplice::constructFloat64RTVal(mayaVec[1]));
-        euler.setMember("z", FabricSplice::constructFloat64RTVal(mayaVec[2]));
+        buffer[i].x = mayaVec[0];
+        buffer[i].y = mayaVec[1];
+        buffer[i].z = mayaVec[2];
       }
-      arrayVal.setArrayElement(i, euler);
     }
 
-    setCB(getSetUD, arrayVal.getFECRTValRef());
+    setRawCB(getSetUD, elements > 0 ? &buffer[0] : NULL, sizeof(KLEuler_d) * elements);
   }
   else {
     FabricCore::RTVal rtVal = getCB(getSetUD);
@@ -1953,7 +2168,6 @@ void dfgPlugToPort_mat44(
   FabricMayaProfilingEvent bracket("dfgPlugToPort_mat44");
 
   uint64_t elementDataSize = sizeof(float) * 16;
-  uint64_t offset = 0;
 
   bool isFloatMatrix = plug.attribute().hasFn(MFn::kFloatMatrixAttribute);
 
@@ -1966,25 +2180,28 @@ void dfgPlugToPort_mat44(
     std::vector<float> buffer(numElements * 16);
     float * values = &buffer[0];
 
+    // gather the Maya matrices first, then transpose them in one pass
     if(isFloatMatrix)
     {
+      std::vector<float> gathered(numElements * 16);
       for(unsigned int i = 0; i < numElements; ++i){
         arrayHandle.jumpToArrayElement(i);
         MDataHandle handle = arrayHandle.inputValue();
-        const MFloatMatrix& mayaMat = handle.asFloatMatrix();
-        MFloatMatrixToMat44_data(mayaMat, &values[offset]);
-        offset += 16;
+        memcpy(&gathered[i * 16], handle.asFloatMatrix().matrix, sizeof(float) * 16);
       }
+      if(numElements > 0)
+        dfgTransposeMat44(&gathered[0], values, numElements);
     }
     else // double
     {
+      std::vector<double> gathered(numElements * 16);
       for(unsigned int i = 0; i < numElements; ++i){
         arrayHandle.jumpToArrayElement(i);
         MDataHandle handle = arrayHandle.inputValue();
-        const MMatrix& mayaMat = handle.asMatrix();
-        MMatrixToMat44_data(mayaMat, &values[offset]);
-        offset += 16;
+        memcpy(&gathered[i * 16], handle.asMatrix().matrix, sizeof(double) * 16);
       }
+      if(numElements > 0)
+        dfgTransposeMat44(&gathered[0], values, numElements);
     }
 
     setRawCB(getSetUD, values, elementDataSize * numElements);
@@ -2025,87 +2242,411 @@ void dfgPlugToPort_mat44_float64(
   MPlug &plug, 
   MDataBlock &data)
 {
-  FabricMayaProfilingEvent bracket("dfgPlugToPort_mat44_float64");
+  FabricMayaProfilingEvent bracket("dfgPlugToPort_mat44_float64");
+
+  uint64_t elementDataSize = sizeof(double) * 16;
+
+  bool isFloatMatrix = plug.attribute().hasFn(MFn::kFloatMatrixAttribute);
+
+  if(plug.isArray()){
+    FTL::AutoProfilingPauseEvent pauseBracket(bracket);
+    MArrayDataHandle arrayHandle = data.inputArrayValue(plug);
+    pauseBracket.resume();
+
+    unsigned int numElements = arrayHandle.elementCount();
+    std::vector<double> buffer(numElements * 16);
+    double * values = &buffer[0];
+
+    // gather the Maya matrices first, then transpose them in one pass
+    if(isFloatMatrix)
+    {
+      std::vector<float> gathered(numElements * 16);
+      for(unsigned int i = 0; i < numElements; ++i){
+        arrayHandle.jumpToArrayElement(i);
+        MDataHandle handle = arrayHandle.inputValue();
+        memcpy(&gathered[i * 16], handle.asFloatMatrix().matrix, sizeof(float) * 16);
+      }
+      if(numElements > 0)
+        dfgTransposeMat44(&gathered[0], values, numElements);
+    }
+    else
+    {
+      std::vector<double> gathered(numElements * 16);
+      for(unsigned int i = 0; i < numElements; ++i){
+        arrayHandle.jumpToArrayElement(i);
+        MDataHandle handle = arrayHandle.inputValue();
+        memcpy(&gathered[i * 16], handle.asMatrix().matrix, sizeof(double) * 16);
+      }
+      if(numElements > 0)
+        dfgTransposeMat44(&gathered[0], values, numElements);
+    }
+
+    setRawCB(getSetUD, values, elementDataSize * numElements);
+  }
+  else{
+    FTL::AutoProfilingPauseEvent pauseBracket(bracket);
+    MDataHandle handle = data.inputValue(plug);
+    pauseBracket.resume();
+
+    double values[16];
+    if(isFloatMatrix)
+    {
+      const MFloatMatrix& mayaMat = handle.asFloatMatrix();
+      MFloatMatrixToMat44_data(mayaMat, values);
+    }
+    else
+    {
+      const MMatrix& mayaMat = handle.asMatrix();
+      MMatrixToMat44_data(mayaMat, values);
+    }
+    setRawCB(getSetUD, values, elementDataSize);
+  }
+}
+
+uint64_t dfgHashBuffer(const void * data, size_t size, uint64_t hash)
+{
+  // FNV-1a
+  const unsigned char * bytes = (const unsigned char *)data;
+  for(size_t i=0;i<size;i++)
+  {
+    hash ^= (uint64_t)bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// the conversion tasks run through dfgParallelFor must not call into
+// KL, as the binding is locked by the caller.
+struct DFGParallelForTaskData
+{
+  DFGParallelForFunc func;
+  void * userData;
+  unsigned int index;
+};
+
+static MThreadRetVal dfgParallelForTask(void * data)
+{
+  DFGParallelForTaskData * taskData = (DFGParallelForTaskData *)data;
+  taskData->func(taskData->userData, taskData->index);
+  return 0;
+}
+
+static void dfgParallelForRegion(void * data, MThreadRootTask * root)
+{
+  std::vector<DFGParallelForTaskData> * tasks = (std::vector<DFGParallelForTaskData> *)data;
+  for(size_t i=0;i<tasks->size();i++)
+    MThreadPool::createTask(dfgParallelForTask, &(*tasks)[i], root);
+  MThreadPool::executeAndJoin(root);
+}
+
+void dfgParallelFor(unsigned int count, DFGParallelForFunc func, void * userData)
+{
+  if(count < 2 || MThreadPool::init() != MS::kSuccess)
+  {
+    for(unsigned int i=0;i<count;i++)
+      func(userData, i);
+    return;
+  }
+
+  std::vector<DFGParallelForTaskData> tasks(count);
+  for(unsigned int i=0;i<count;i++)
+  {
+    tasks[i].func = func;
+    tasks[i].userData = userData;
+    tasks[i].index = i;
+  }
+
+  MThreadPool::newParallelRegion(dfgParallelForRegion, &tasks);
+  MThreadPool::release();
+}
+
+// fingerprint of the lines or curve last written to an output plug
+struct DFGCurveOutputCache
+{
+  bool valid;
+  MObjectHandle curveObject;
+  uint64_t hash;
+
+  DFGCurveOutputCache()
+  : valid(false)
+  , hash(0)
+  {}
+};
+
+// per port caches of the geometry fed into the graphs and written to the
+// output plugs, keyed by node and by plug (including the array element's
+// position in the port).
+struct DFGGeometryNodeCache
+{
+  MObjectHandle node;
+  std::map<std::string, DFGPolygonMeshCache> plugs;
+  std::map<std::string, DFGPolygonMeshOutputCache> outputs;
+  std::map<std::string, DFGCurveOutputCache> curveOutputs;
+};
+static std::map<unsigned int, DFGGeometryNodeCache> s_geometryCaches;
+static MMutexLock s_geometryCachesLock;
+
+static std::string dfgGeometryCacheKey(MPlug & plug, int elementPosition)
+{
+  std::string key = plug.partialName().asChar();
+  if(elementPosition >= 0)
+  {
+    char buffer[32];
+#ifdef _WIN32
+    _snprintf(buffer, 32, "[%d]", elementPosition);
+#else
+    snprintf(buffer, 32, "[%d]", elementPosition);
+#endif
+    key += buffer;
+  }
+  return key;
+}
+
+// returns a copy of the cache, as the entries can be dropped by
+// dfgClearPolygonMeshCache at any time. store it back once updated.
+template<typename Cache>
+static Cache dfgGetGeometryCache(std::map<std::string, Cache> DFGGeometryNodeCache::*caches, MPlug & plug, int elementPosition)
+{
+  MObjectHandle nodeHandle(plug.node());
+  std::string key = dfgGeometryCacheKey(plug, elementPosition);
+
+  Cache cache;
+  s_geometryCachesLock.lock();
+  std::map<unsigned int, DFGGeometryNodeCache>::iterator it = s_geometryCaches.find(nodeHandle.hashCode());
+  if(it != s_geometryCaches.end() && it->second.node == nodeHandle)
+  {
+    typename std::map<std::string, Cache>::iterator plugIt = (it->second.*caches).find(key);
+    if(plugIt != (it->second.*caches).end())
+      cache = plugIt->second;
+  }
+  s_geometryCachesLock.unlock();
+  return cache;
+}
+
+template<typename Cache>
+static void dfgSetGeometryCache(std::map<std::string, Cache> DFGGeometryNodeCache::*caches, MPlug & plug, int elementPosition, const Cache & cache)
+{
+  MObjectHandle nodeHandle(plug.node());
+  std::string key = dfgGeometryCacheKey(plug, elementPosition);
+
+  s_geometryCachesLock.lock();
+  DFGGeometryNodeCache & nodeCache = s_geometryCaches[nodeHandle.hashCode()];
+  if(!(nodeCache.node == nodeHandle))
+  {
+    nodeCache.node = nodeHandle;
+    nodeCache.plugs.clear();
+    nodeCache.outputs.clear();
+    nodeCache.curveOutputs.clear();
+  }
+  (nodeCache.*caches)[key] = cache;
+  s_geometryCachesLock.unlock();
+}
+
+static DFGPolygonMeshCache dfgGetPolygonMeshCache(MPlug & plug, int elementPosition = -1)
+{
+  return dfgGetGeometryCache(&DFGGeometryNodeCache::plugs, plug, elementPosition);
+}
+
+static void dfgSetPolygonMeshCache(MPlug & plug, int elementPosition, const DFGPolygonMeshCache & cache)
+{
+  dfgSetGeometryCache(&DFGGeometryNodeCache::plugs, plug, elementPosition, cache);
+}
+
+// drops the caches of a port whose conversion failed half way
+static void dfgInvalidatePolygonMeshCaches(MPlug & plug, size_t count)
+{
+  for(size_t i=0;i<count;i++)
+    dfgSetPolygonMeshCache(plug, plug.isArray() ? (int)i : -1, DFGPolygonMeshCache());
+}
+
+void dfgClearPolygonMeshCache(MObject node)
+{
+  MObjectHandle nodeHandle(node);
+  s_geometryCachesLock.lock();
+  std::map<unsigned int, DFGGeometryNodeCache>::iterator it = s_geometryCaches.begin();
+  while(it != s_geometryCaches.end())
+  {
+    // drop the entry of this node as well as the ones of deleted nodes
+    if(it->second.node == nodeHandle || !it->second.node.isAlive())
+      s_geometryCaches.erase(it++);
+    else
+      ++it;
+  }
+  s_geometryCachesLock.unlock();
+}
 
-  uint64_t elementDataSize = sizeof(double) * 16;
-  uint64_t offset = 0;
+// the Maya side data of a mesh, gathered (and packed) separately
+// from the KL calls so that several meshes can be processed concurrently.
+struct DFGPolygonMeshData
+{
+  // false if the mesh couldn't be read, the port keeps its previous mesh then
+  bool valid;
+  unsigned int nbPoints;
+  unsigned int nbPolygons;
+  unsigned int nbSamples;
+
+  MPointArray points;
+  MIntArray counts;
+  MIntArray indices;
+  uint64_t topologyHash;
+
+  bool hasNormals;
+  uint64_t normalsHash;
+  MFloatVectorArray normals;
+  MIntArray normalIds;
+  MFloatVectorArray normalValues;
+
+  bool hasUVs;
+  uint64_t uvsHash;
+  MFloatArray u;
+  MFloatArray v;
+  MIntArray uvIds;
+  MFloatArray uvValues;
+
+  bool hasColors;
+  uint64_t colorsHash;
+  MColorArray colors;
+
+  DFGPolygonMeshData()
+  : valid(false)
+  , nbPoints(0)
+  , nbPolygons(0)
+  , nbSamples(0)
+  , topologyHash(DFG_HASH_SEED)
+  , hasNormals(false)
+  , normalsHash(DFG_HASH_SEED)
+  , hasUVs(false)
+  , uvsHash(DFG_HASH_SEED)
+  , hasColors(false)
+  , colorsHash(DFG_HASH_SEED)
+  {}
+};
 
-  bool isFloatMatrix = plug.attribute().hasFn(MFn::kFloatMatrixAttribute);
+static void dfgPackPolygonMeshNormals(DFGPolygonMeshData & meshData)
+{
+  if(!meshData.hasNormals || meshData.normalValues.length() > 0)
+    return;
 
-  if(plug.isArray()){
-    FTL::AutoProfilingPauseEvent pauseBracket(bracket);
-    MArrayDataHandle arrayHandle = data.inputArrayValue(plug);
-    pauseBracket.resume();
+  meshData.normalValues.setLength(meshData.normalIds.length());
+  for(unsigned int i=0;i<meshData.normalIds.length();i++)
+    meshData.normalValues[i] = meshData.normals[meshData.normalIds[i]];
+}
 
-    unsigned int numElements = arrayHandle.elementCount();
-    std::vector<double> buffer(numElements * 16);
-    double * values = &buffer[0];
+static void dfgPackPolygonMeshUVs(DFGPolygonMeshData & meshData)
+{
+  if(!meshData.hasUVs || meshData.uvValues.length() > 0)
+    return;
 
-    if(isFloatMatrix)
-    {
-      for(unsigned int i = 0; i < numElements; ++i){
-        arrayHandle.jumpToArrayElement(i);
-        MDataHandle handle = arrayHandle.inputValue();
-        const MFloatMatrix& mayaMat = handle.asFloatMatrix();
-        MFloatMatrixToMat44_data(mayaMat, &values[offset]);
-        offset += 16;
-      }
-    }
-    else
-    {
-      for(unsigned int i = 0; i < numElements; ++i){
-        arrayHandle.jumpToArrayElement(i);
-        MDataHandle handle = arrayHandle.inputValue();
-        const MMatrix& mayaMat = handle.asMatrix();
-        MMatrixToMat44_data(mayaMat, &values[offset]);
-        offset += 16;
-      }
-    }
+  meshData.uvValues.setLength(meshData.uvIds.length() * 2);
+  unsigned int offset = 0;
+  for(unsigned int i=0;i<meshData.uvIds.length(); i++)
+  {
+    meshData.uvValues[offset++] = meshData.u[meshData.uvIds[i]];
+    meshData.uvValues[offset++] = meshData.v[meshData.uvIds[i]];
+  }
+}
 
-    setRawCB(getSetUD, values, elementDataSize * numElements);
+// only reads from Maya and doesn't call into KL. the components which
+// didn't change according to the cache are not packed (yet).
+// normals, uvs and colors are still read and hashed on every call: MFnMesh
+// has no per component change indicator, and a dirty mesh plug doesn't tell
+// a deformation apart from a uv or color edit.
+static void dfgGatherPolygonMeshData(MFnMesh & mesh, DFGPolygonMeshData & meshData, const DFGPolygonMeshCache * cache)
+{
+  bool cacheValid = cache != NULL && cache->valid;
+
+  meshData.valid = true;
+  meshData.nbPoints = mesh.numVertices();
+  meshData.nbPolygons = mesh.numPolygons();
+  meshData.nbSamples = mesh.numFaceVertices();
+
+  mesh.getPoints(meshData.points);
+  mesh.getVertices(meshData.counts, meshData.indices);
+  if(meshData.counts.length() > 0)
+    meshData.topologyHash = dfgHashBuffer(&meshData.counts[0], sizeof(int) * meshData.counts.length(), meshData.topologyHash);
+  if(meshData.indices.length() > 0)
+    meshData.topologyHash = dfgHashBuffer(&meshData.indices[0], sizeof(int) * meshData.indices.length(), meshData.topologyHash);
+  cacheValid = cacheValid && meshData.topologyHash == cache->topologyHash;
+
+  MIntArray normalCounts;
+  mesh.getNormals(meshData.normals);
+  mesh.getNormalIds(normalCounts, meshData.normalIds);
+  meshData.hasNormals = meshData.normals.length() > 0 && normalCounts.length() > 0 && meshData.normalIds.length() > 0;
+  if(meshData.hasNormals)
+  {
+    meshData.normalsHash = dfgHashBuffer(&meshData.normals[0], sizeof(MFloatVector) * meshData.normals.length(), meshData.normalsHash);
+    meshData.normalsHash = dfgHashBuffer(&meshData.normalIds[0], sizeof(int) * meshData.normalIds.length(), meshData.normalsHash);
+    if(!cacheValid || meshData.normalsHash != cache->normalsHash)
+      dfgPackPolygonMeshNormals(meshData);
   }
-  else{
-    FTL::AutoProfilingPauseEvent pauseBracket(bracket);
-    MDataHandle handle = data.inputValue(plug);
-    pauseBracket.resume();
 
-    double values[16];
-    if(isFloatMatrix)
+  if(mesh.numUVSets() > 0)
+  {
+    MIntArray uvCounts;
+    mesh.getUVs(meshData.u, meshData.v);
+    mesh.getAssignedUVs(uvCounts, meshData.uvIds);
+    meshData.hasUVs = meshData.uvIds.length() > 0;
+    if(meshData.hasUVs)
     {
-      const MFloatMatrix& mayaMat = handle.asFloatMatrix();
-      MFloatMatrixToMat44_data(mayaMat, values);
+      if(meshData.u.length() > 0)
+        meshData.uvsHash = dfgHashBuffer(&meshData.u[0], sizeof(float) * meshData.u.length(), meshData.uvsHash);
+      if(meshData.v.length() > 0)
+        meshData.uvsHash = dfgHashBuffer(&meshData.v[0], sizeof(float) * meshData.v.length(), meshData.uvsHash);
+      meshData.uvsHash = dfgHashBuffer(&meshData.uvIds[0], sizeof(int) * meshData.uvIds.length(), meshData.uvsHash);
+      if(!cacheValid || meshData.uvsHash != cache->uvsHash)
+        dfgPackPolygonMeshUVs(meshData);
     }
-    else
+  }
+
+  if(mesh.numColorSets() > 0)
+  {
+    MStringArray colorSetNames;
+    mesh.getColorSetNames(colorSetNames);
+    MString colorSetName = colorSetNames[0];
+
+    mesh.getFaceVertexColors(meshData.colors, &colorSetName);
+    meshData.hasColors = meshData.colors.length() > 0;
+    if(meshData.hasColors)
     {
-      const MMatrix& mayaMat = handle.asMatrix();
-      MMatrixToMat44_data(mayaMat, values);
+      meshData.colorsHash = dfgHashBuffer(colorSetName.asChar(), colorSetName.length(), meshData.colorsHash);
+      meshData.colorsHash = dfgHashBuffer(&meshData.colors[0], sizeof(MColor) * meshData.colors.length(), meshData.colorsHash);
     }
-    setRawCB(getSetUD, values, elementDataSize);
   }
 }
 
-FabricCore::RTVal dfgMFnMeshToPolygonMesh(MFnMesh & mesh, FabricCore::RTVal rtMesh)
+// issues the KL calls for gathered mesh data, only uploading
+// the topology and the components which changed.
+static FabricCore::RTVal dfgUploadPolygonMeshData(DFGPolygonMeshData & meshData, FabricCore::RTVal rtMesh, DFGPolygonMeshCache * cache)
 {
   if(!rtMesh.isValid())
     return rtMesh;
 
-  // determine if we need a topology update
-  bool requireTopoUpdate = false;
+  // determine if we need a topology update. the counts are compared first, 
+  // the fingerprint of the counts and indices catches same-count edits.
+  bool requireTopoUpdate = cache == NULL || !cache->valid;
+  if(!requireTopoUpdate)
+  {
+    uint64_t nbPoints = rtMesh.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
+    requireTopoUpdate = nbPoints != (uint64_t)meshData.nbPoints;
+  }
   if(!requireTopoUpdate)
   {
     uint64_t nbPolygons = rtMesh.callMethod("UInt64", "polygonCount", 0, 0).getUInt64();
-    requireTopoUpdate = nbPolygons != (uint64_t)mesh.numPolygons();
+    requireTopoUpdate = nbPolygons != (uint64_t)meshData.nbPolygons;
   }
   if(!requireTopoUpdate)
   {
     uint64_t nbSamples = rtMesh.callMethod("UInt64", "polygonPointsCount", 0, 0).getUInt64();
-    requireTopoUpdate = nbSamples != (uint64_t)mesh.numFaceVertices();
+    requireTopoUpdate = nbSamples != (uint64_t)meshData.nbSamples;
   }
+  if(!requireTopoUpdate)
+    requireTopoUpdate = meshData.topologyHash != cache->topologyHash;
 
-  MPointArray mayaPoints;
-  MIntArray mayaCounts, mayaIndices;
-
-  mesh.getPoints(mayaPoints);
+  if(cache)
+  {
+    cache->valid = false;
+    cache->topologyHash = meshData.topologyHash;
+  }
 
   if(requireTopoUpdate)
   {
@@ -2113,97 +2654,99 @@ FabricCore::RTVal dfgMFnMeshToPolygonMesh(MFnMesh & mesh, FabricCore::RTVal rtMe
     rtMesh.callMethod("", "clear", 0, NULL);
   }
 
-  if(mayaPoints.length() > 0)
+  if(meshData.points.length() > 0)
   {
     std::vector<FabricCore::RTVal> args(2);
-    args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float64", meshData.points.length() * 4, &meshData.points[0]);
     args[1] = FabricSplice::constructUInt32RTVal(4); // components
     rtMesh.callMethod("", "setPointsFromExternalArray_d", 2, &args[0]);
-    mayaPoints.clear();
   }
 
   if(requireTopoUpdate)
   {
-    mesh.getVertices(mayaCounts, mayaIndices);
     std::vector<FabricCore::RTVal> args(2);
-    args[0] = FabricSplice::constructExternalArrayRTVal("UInt32", mayaCounts.length(), &mayaCounts[0]);
-    args[1] = FabricSplice::constructExternalArrayRTVal("UInt32", mayaIndices.length(), &mayaIndices[0]);
+    args[0] = FabricSplice::constructExternalArrayRTVal("UInt32", meshData.counts.length(), &meshData.counts[0]);
+    args[1] = FabricSplice::constructExternalArrayRTVal("UInt32", meshData.indices.length(), &meshData.indices[0]);
     rtMesh.callMethod("", "setTopologyFromCountsIndicesExternalArrays", 2, &args[0]);
   }
 
-  MFloatVectorArray mayaNormals;
-  MIntArray mayaNormalsCounts, mayaNormalsIds;
-  mesh.getNormals(mayaNormals);
-  mesh.getNormalIds(mayaNormalsCounts, mayaNormalsIds);
-
-  if(mayaNormals.length() > 0 && mayaNormalsCounts.length() > 0 && mayaNormalsIds.length() > 0)
+  if(meshData.hasNormals)
   {
-    MFloatVectorArray values;
-    values.setLength(mayaNormalsIds.length());
-
-    unsigned int offset = 0;
-    for(unsigned int i=0;i<mayaNormalsIds.length();i++)
-      values[offset++] = mayaNormals[mayaNormalsIds[i]];
+    if(requireTopoUpdate || meshData.normalsHash != cache->normalsHash)
+    {
+      dfgPackPolygonMeshNormals(meshData);
+      std::vector<FabricCore::RTVal> args(1);
+      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", meshData.normalValues.length() * 3, &meshData.normalValues[0]);
+      rtMesh.callMethod("", "setNormalsFromExternalArray", 1, &args[0]);
+    }
 
-    std::vector<FabricCore::RTVal> args(1);
-    args[0] = FabricSplice::constructExternalArrayRTVal("Float32", values.length() * 3, &values[0]);
-    rtMesh.callMethod("", "setNormalsFromExternalArray", 1, &args[0]);
-    values.clear();
+    if(cache)
+      cache->normalsHash = meshData.normalsHash;
   }
 
-  if(mesh.numUVSets() > 0)
+  if(meshData.hasUVs)
   {
-    MFloatArray u, v, values;
-    mesh.getUVs(u, v);
-    unsigned int offset = 0;
-
-    MIntArray counts, indices;
-    mesh.getAssignedUVs(counts, indices);
-    counts.clear();
-    values.setLength(indices.length() * 2);
-    if(values.length() > 0)
+    if(requireTopoUpdate || meshData.uvsHash != cache->uvsHash)
     {
-      for(unsigned int i=0;i<indices.length(); i++)
-      {
-        values[offset++] = u[indices[i]];
-        values[offset++] = v[indices[i]];
-      }
-      u.clear();
-      v.clear();
-
+      dfgPackPolygonMeshUVs(meshData);
       std::vector<FabricCore::RTVal> args(2);
-      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", values.length(), &values[0]);
+      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", meshData.uvValues.length(), &meshData.uvValues[0]);
       args[1] = FabricSplice::constructUInt32RTVal(2); // components
       rtMesh.callMethod("", "setUVsFromExternalArray", 2, &args[0]);
-      values.clear();
     }
+
+    if(cache)
+      cache->uvsHash = meshData.uvsHash;
   }
 
-  if(mesh.numColorSets() > 0)
+  if(meshData.hasColors)
   {
-    MColorArray faceValues;
-
-    MStringArray colorSetNames;
-    mesh.getColorSetNames(colorSetNames);
-    MString colorSetName = colorSetNames[0];
-
-    mesh.getFaceVertexColors(faceValues, &colorSetName);
-    if(faceValues.length() > 0)
+    if(requireTopoUpdate || meshData.colorsHash != cache->colorsHash)
     {
       std::vector<FabricCore::RTVal> args(2);
-      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", faceValues.length() * 4, &faceValues[0]);
+      args[0] = FabricSplice::constructExternalArrayRTVal("Float32", meshData.colors.length() * 4, &meshData.colors[0]);
       args[1] = FabricSplice::constructUInt32RTVal(4); // components
       rtMesh.callMethod("", "setVertexColorsFromExternalArray", 2, &args[0]);
-      faceValues.clear();
     }
+
+    if(cache)
+      cache->colorsHash = meshData.colorsHash;
   }
 
-  mayaCounts.clear();
-  mayaIndices.clear();
+  // only mark the cache as valid once all of the uploads went through
+  if(cache)
+    cache->valid = true;
 
   return rtMesh;
 }
 
+FabricCore::RTVal dfgMFnMeshToPolygonMesh(MFnMesh & mesh, FabricCore::RTVal rtMesh, DFGPolygonMeshCache * cache)
+{
+  if(!rtMesh.isValid())
+    return rtMesh;
+
+  DFGPolygonMeshData meshData;
+  dfgGatherPolygonMeshData(mesh, meshData, cache);
+  return dfgUploadPolygonMeshData(meshData, rtMesh, cache);
+}
+
+struct DFGGatherPolygonMeshesData
+{
+  std::vector<MObject> * meshObjects;
+  std::vector<DFGPolygonMeshCache *> * caches;
+  std::vector<DFGPolygonMeshData> * meshData;
+};
+
+static void dfgGatherPolygonMeshesTask(void * userData, unsigned int index)
+{
+  DFGGatherPolygonMeshesData * gatherData = (DFGGatherPolygonMeshesData *)userData;
+  MStatus status;
+  MFnMesh mesh((*gatherData->meshObjects)[index], &status);
+  if(status != MS::kSuccess)
+    return;
+  dfgGatherPolygonMeshData(mesh, (*gatherData->meshData)[index], (*gatherData->caches)[index]);
+}
+
 void dfgPlugToPort_PolygonMesh(
   unsigned argIndex,
   char const *argName,
@@ -2222,8 +2765,14 @@ void dfgPlugToPort_PolygonMesh(
 
   std::vector<MDataHandle> handles;
   std::vector<FabricCore::RTVal> rtVals;
+  std::vector<DFGPolygonMeshCache> cacheValues;
+  std::vector<DFGPolygonMeshCache *> caches;
   FabricCore::RTVal portRTVal;
 
+  // IO ports can be modified by the graph, so the meshes
+  // fed into them cannot be tracked across evaluations.
+  bool useCache = argOutsidePortType == FabricCore::DFGPortType_In;
+
   // [FE-8264]
   if (   FTL::CStrRef(argName) == FTL_STR("meshes")
       && plug.partialName()    == "meshes"
@@ -2247,6 +2796,13 @@ void dfgPlugToPort_PolygonMesh(
         arrayHandle.jumpToArrayElement(i);
         handles.push_back(arrayHandle.inputValue());
 
+        // the cache is keyed by the element's position, as that's the
+        // mesh in the port it describes. the logical indices of sparse
+        // arrays shift against the positions when elements are removed.
+        DFGPolygonMeshCache cache;
+        if(useCache)
+          cache = dfgGetPolygonMeshCache(plug, (int)i);
+
         FabricCore::RTVal polygonMesh;
         if(portRTVal.isArray())
         {
@@ -2254,6 +2810,7 @@ void dfgPlugToPort_PolygonMesh(
           {
             polygonMesh = FabricSplice::constructObjectRTVal("PolygonMesh");
             portRTVal.callMethod("", "push", 1, &polygonMesh);
+            cache.valid = false;
           }
           else
           {
@@ -2262,6 +2819,7 @@ void dfgPlugToPort_PolygonMesh(
             {
               polygonMesh = FabricSplice::constructObjectRTVal("PolygonMesh");
               portRTVal.setArrayElement(i, polygonMesh);
+              cache.valid = false;
             }
           }
           rtVals.push_back(polygonMesh);
@@ -2269,9 +2827,13 @@ void dfgPlugToPort_PolygonMesh(
         else
         {
           if(!portRTVal.isValid() || portRTVal.isNullObject())
+          {
             portRTVal = FabricSplice::constructObjectRTVal("PolygonMesh");
+            cache.valid = false;
+          }
           rtVals.push_back(portRTVal);
         }
+        cacheValues.push_back(cache);
       }
 
       if (elements < portRTVal.getArraySize())
@@ -2286,19 +2848,50 @@ void dfgPlugToPort_PolygonMesh(
       handles.push_back(data.inputValue(plug));
       pauseBracket.resume();
 
-      if(argOutsidePortType == FabricCore::DFGPortType_IO)
-        portRTVal = getCB(getSetUD);
-      if(!portRTVal.isValid() || portRTVal.isNullObject())
+      DFGPolygonMeshCache cache;
+      if(useCache)
+        cache = dfgGetPolygonMeshCache(plug);
+
+      // In ports reuse their previous mesh as well, so that
+      // the unchanged components don't have to be uploaded again.
+      portRTVal = getCB(getSetUD);
+      if(!portRTVal.isValid() || !portRTVal.isObject() || portRTVal.isNullObject())
+      {
         portRTVal = FabricSplice::constructObjectRTVal("PolygonMesh");
+        cache.valid = false;
+      }
       rtVals.push_back(portRTVal);
+      cacheValues.push_back(cache);
     }
 
+    caches.resize(cacheValues.size(), NULL);
+    if(useCache)
+    {
+      for(size_t cacheIndex=0;cacheIndex<cacheValues.size();cacheIndex++)
+        caches[cacheIndex] = &cacheValues[cacheIndex];
+    }
+
+    // gather the meshes concurrently, then upload them in order
+    std::vector<MObject> meshObjects(handles.size());
+    for(size_t handleIndex=0;handleIndex<handles.size();handleIndex++) 
+      meshObjects[handleIndex] = handles[handleIndex].asMesh();
+
+    std::vector<DFGPolygonMeshData> meshData(handles.size());
+    DFGGatherPolygonMeshesData gatherData;
+    gatherData.meshObjects = &meshObjects;
+    gatherData.caches = &caches;
+    gatherData.meshData = &meshData;
+    dfgParallelFor((unsigned int)handles.size(), dfgGatherPolygonMeshesTask, &gatherData);
+
     for(size_t handleIndex=0;handleIndex<handles.size();handleIndex++) 
     {
-      MObject meshObj = handles[handleIndex].asMesh();
-      MFnMesh mesh(meshObj);
-      FabricCore::RTVal polygonMesh = rtVals[handleIndex];
-      polygonMesh = dfgMFnMeshToPolygonMesh(mesh, polygonMesh);
+      if(meshData[handleIndex].valid)
+      {
+        FabricCore::RTVal polygonMesh = rtVals[handleIndex];
+        polygonMesh = dfgUploadPolygonMeshData(meshData[handleIndex], polygonMesh, caches[handleIndex]);
+      }
+      if(useCache)
+        dfgSetPolygonMeshCache(plug, plug.isArray() ? (int)handleIndex : -1, cacheValues[handleIndex]);
     }
 
     setCB(getSetUD, portRTVal.getFECRTValRef());
@@ -2306,15 +2899,81 @@ void dfgPlugToPort_PolygonMesh(
   catch(FabricCore::Exception e)
   {
     mayaLogErrorFunc(e.getDesc_cstr());
+    if(useCache)
+      dfgInvalidatePolygonMeshCaches(plug, cacheValues.size());
     return;
   }
   catch(FabricSplice::Exception e)
   {
     mayaLogErrorFunc(e.what());
+    if(useCache)
+      dfgInvalidatePolygonMeshCaches(plug, cacheValues.size());
     return;
   }
 }
 
+struct DFGLinesData
+{
+  // false if the curve couldn't be read, the port keeps its previous lines then
+  bool valid;
+  std::vector<double> positions;
+  std::vector<uint32_t> indices;
+
+  DFGLinesData()
+  : valid(false)
+  {}
+};
+
+struct DFGGatherLinesData
+{
+  std::vector<MObject> * curveObjects;
+  std::vector<DFGLinesData> * linesData;
+};
+
+static void dfgGatherLinesTask(void * userData, unsigned int index)
+{
+  DFGGatherLinesData * gatherData = (DFGGatherLinesData *)userData;
+  MStatus status;
+  MFnNurbsCurve curve((*gatherData->curveObjects)[index], &status);
+  if(status != MS::kSuccess)
+    return;
+  DFGLinesData & linesData = (*gatherData->linesData)[index];
+  linesData.valid = true;
+
+  MPointArray mayaPoints;
+  curve.getCVs(mayaPoints);
+  if(mayaPoints.length() == 0)
+    return;
+  std::vector<double> & mayaDoubles = linesData.positions;
+  mayaDoubles.resize(mayaPoints.length() * 3);
+
+  size_t nbSegments = (mayaPoints.length() - 1);
+  if(curve.form() == MFnNurbsCurve::kClosed)
+    nbSegments++;
+
+  std::vector<uint32_t> & mayaIndices = linesData.indices;
+  mayaIndices.resize(nbSegments * 2);
+
+  size_t voffset = 0;
+  size_t coffset = 0;
+  for(unsigned int i=0;i<mayaPoints.length();i++)
+  {
+    mayaDoubles[voffset++] = mayaPoints[i].x;
+    mayaDoubles[voffset++] = mayaPoints[i].y;
+    mayaDoubles[voffset++] = mayaPoints[i].z;
+    if(i < mayaPoints.length() - 1)
+    {
+      mayaIndices[coffset++] = i;
+      mayaIndices[coffset++] = i + 1;
+    }
+    else if(curve.form() == MFnNurbsCurve::kClosed)
+    {
+      mayaIndices[coffset++] = i;
+      mayaIndices[coffset++] = 0;
+    }
+  }
+}
+
 void dfgPlugToPort_Lines(
   unsigned argIndex,
   char const *argName,
@@ -2387,45 +3046,29 @@ void dfgPlugToPort_Lines(
       rtVals.push_back(portRTVal);
     }
 
+    // gather the curves concurrently, then upload them in order
+    std::vector<MObject> curveObjects(handles.size());
     for(size_t handleIndex=0;handleIndex<handles.size();handleIndex++) 
-    {
-      MObject curveObj = handles[handleIndex].asNurbsCurve();
-      MFnNurbsCurve curve(curveObj);
-      FabricCore::RTVal rtVal = rtVals[handleIndex];
-
-      MPointArray mayaPoints;
-      curve.getCVs(mayaPoints);
-      std::vector<double> mayaDoubles(mayaPoints.length() * 3);
+      curveObjects[handleIndex] = handles[handleIndex].asNurbsCurve();
 
-      size_t nbSegments = (mayaPoints.length() - 1);
-      if(curve.form() == MFnNurbsCurve::kClosed)
-        nbSegments++;
+    std::vector<DFGLinesData> linesData(handles.size());
+    DFGGatherLinesData gatherData;
+    gatherData.curveObjects = &curveObjects;
+    gatherData.linesData = &linesData;
+    dfgParallelFor((unsigned int)handles.size(), dfgGatherLinesTask, &gatherData);
 
-      std::vector<uint32_t> mayaIndices(nbSegments * 2);
-
-      size_t voffset = 0;
-      size_t coffset = 0;
-      for(unsigned int i=0;i<mayaPoints.length();i++)
-      {
-        mayaDoubles[voffset++] = mayaPoints[i].x;
-        mayaDoubles[voffset++] = mayaPoints[i].y;
-        mayaDoubles[voffset++] = mayaPoints[i].z;
-        if(i < mayaPoints.length() - 1)
-        {
-          mayaIndices[coffset++] = i;
-          mayaIndices[coffset++] = i + 1;
-        }
-        else if(curve.form() == MFnNurbsCurve::kClosed)
-        {
-          mayaIndices[coffset++] = i;
-          mayaIndices[coffset++] = 0;
-        }
-      }
+    for(size_t handleIndex=0;handleIndex<handles.size();handleIndex++) 
+    {
+      if(!linesData[handleIndex].valid)
+        continue;
+      FabricCore::RTVal rtVal = rtVals[handleIndex];
+      std::vector<double> & mayaDoubles = linesData[handleIndex].positions;
+      std::vector<uint32_t> & mayaIndices = linesData[handleIndex].indices;
 
-      FabricCore::RTVal mayaDoublesVal = FabricSplice::constructExternalArrayRTVal("Float64", mayaDoubles.size(), &mayaDoubles[0]);
+      FabricCore::RTVal mayaDoublesVal = FabricSplice::constructExternalArrayRTVal("Float64", mayaDoubles.size(), mayaDoubles.size() > 0 ? &mayaDoubles[0] : NULL);
       rtVal.callMethod("", "_setPositionsFromExternalArray_d", 1, &mayaDoublesVal);
 
-      FabricCore::RTVal mayaIndicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", mayaIndices.size(), &mayaIndices[0]);
+      FabricCore::RTVal mayaIndicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", mayaIndices.size(), mayaIndices.size() > 0 ? &mayaIndices[0] : NULL);
       rtVal.callMethod("", "_setTopologyFromExternalArray", 1, &mayaIndicesVal);
     }
 
@@ -2443,14 +3086,26 @@ void dfgPlugToPort_Lines(
   }
 }
 
-bool dfgMFnNurbsCurveToCurves(unsigned int index, MFnNurbsCurve & curve, FabricCore::RTVal & rtCurves)
+struct DFGCurveData
 {
-  if(!rtCurves.isValid())
-    return false;
+  // false if the curve couldn't be read, the port keeps its previous curve then
+  bool valid;
+  uint8_t degree;
+  uint8_t form;
+  MPointArray points;
+  MDoubleArray knots;
+
+  DFGCurveData()
+  : valid(false)
+  , degree(0)
+  , form(0)
+  {}
+};
 
-  FabricCore::RTVal args[ 6 ];
-  args[0] = FabricSplice::constructUInt32RTVal(index);
-  args[1] = FabricSplice::constructUInt8RTVal(uint8_t( curve.degree() ));
+static void dfgGatherCurveData(MFnNurbsCurve & curve, DFGCurveData & curveData)
+{
+  curveData.valid = true;
+  curveData.degree = uint8_t( curve.degree() );
 
   uint8_t curveForm = uint8_t(curve.form());
   if( curveForm == MFnNurbsCurve::kOpen )
@@ -2459,21 +3114,54 @@ bool dfgMFnNurbsCurveToCurves(unsigned int index, MFnNurbsCurve & curve, FabricC
     curveForm = 1;//curveForm_closed
   else if( curveForm == MFnNurbsCurve::kPeriodic )
     curveForm = 2;//curveForm_periodic
+  curveData.form = curveForm;
 
-  args[2] = FabricSplice::constructUInt8RTVal(curveForm);
+  curve.getCVs( curveData.points );
+  curve.getKnots( curveData.knots );
+}
 
-  MPointArray mayaPoints;
-  curve.getCVs( mayaPoints );
-  args[3] = FabricSplice::constructExternalArrayRTVal( "Float64", mayaPoints.length() * 4, &mayaPoints[0] );
+static bool dfgUploadCurveData(unsigned int index, DFGCurveData & curveData, FabricCore::RTVal & rtCurves)
+{
+  if(!rtCurves.isValid())
+    return false;
 
-  MDoubleArray mayaKnots;
-  curve.getKnots( mayaKnots );
-  args[4] = FabricSplice::constructExternalArrayRTVal( "Float64", mayaKnots.length(), &mayaKnots[0] );
+  FabricCore::RTVal args[ 6 ];
+  args[0] = FabricSplice::constructUInt32RTVal(index);
+  args[1] = FabricSplice::constructUInt8RTVal(curveData.degree);
+  args[2] = FabricSplice::constructUInt8RTVal(curveData.form);
+  args[3] = FabricSplice::constructExternalArrayRTVal( "Float64", curveData.points.length() * 4, &curveData.points[0] );
+  args[4] = FabricSplice::constructExternalArrayRTVal( "Float64", curveData.knots.length(), &curveData.knots[0] );
 
   rtCurves.callMethod( "", "setCurveFromMaya", 5, args );
   return true;
 }
 
+bool dfgMFnNurbsCurveToCurves(unsigned int index, MFnNurbsCurve & curve, FabricCore::RTVal & rtCurves)
+{
+  if(!rtCurves.isValid())
+    return false;
+
+  DFGCurveData curveData;
+  dfgGatherCurveData(curve, curveData);
+  return dfgUploadCurveData(index, curveData, rtCurves);
+}
+
+struct DFGGatherCurvesData
+{
+  std::vector<MObject> * curveObjects;
+  std::vector<DFGCurveData> * curveData;
+};
+
+static void dfgGatherCurvesTask(void * userData, unsigned int index)
+{
+  DFGGatherCurvesData * gatherData = (DFGGatherCurvesData *)userData;
+  MStatus status;
+  MFnNurbsCurve curve((*gatherData->curveObjects)[index], &status);
+  if(status != MS::kSuccess)
+    return;
+  dfgGatherCurveData(curve, (*gatherData->curveData)[index]);
+}
+
 void dfgPlugToPort_CurveOrCurves(
   bool singleCurve,
   unsigned argIndex,
@@ -2533,10 +3221,20 @@ void dfgPlugToPort_CurveOrCurves(
       rtVal.callMethod( "", "setCurveCount", 1, &curveCountRTVal );
     }
 
+    // gather the curves concurrently, then upload them in order
+    std::vector<MObject> curveObjects( handles.size() );
+    for( size_t handleIndex = 0; handleIndex<handles.size(); handleIndex++ )
+      curveObjects[handleIndex] = handles[handleIndex].asNurbsCurve();
+
+    std::vector<DFGCurveData> curveData( handles.size() );
+    DFGGatherCurvesData gatherData;
+    gatherData.curveObjects = &curveObjects;
+    gatherData.curveData = &curveData;
+    dfgParallelFor( (unsigned int)handles.size(), dfgGatherCurvesTask, &gatherData );
+
     for( size_t handleIndex = 0; handleIndex<handles.size(); handleIndex++ ) {
-      MObject curveObj = handles[handleIndex].asNurbsCurve();
-      MFnNurbsCurve curve( curveObj );
-      dfgMFnNurbsCurveToCurves((unsigned int)handleIndex, curve, rtVal);
+      if( curveData[handleIndex].valid )
+        dfgUploadCurveData( (unsigned int)handleIndex, curveData[handleIndex], rtVal );
     }
 
     setCB( getSetUD, portRTVal.getFECRTValRef() );
@@ -2607,56 +3305,71 @@ void dfgPlugToPort_Curve(
     data );
 }
 
-void dfgPlugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal & trackVal) {
-
-  FabricMayaProfilingEvent bracket("dfgPlugToPort_KeyframeTrack_helper");
+// converted tracks per anim curve, invalidated when the curve is edited.
+struct DFGKeyframeTrackCacheEntry
+{
+  MObjectHandle curve;
+  MString name;
+  FabricCore::RTVal trackVal;
+};
+static std::map<unsigned int, DFGKeyframeTrackCacheEntry> s_keyframeTrackCache;
+static MMutexLock s_keyframeTrackCacheLock;
 
-  CORE_CATCH_BEGIN;
+// expects s_keyframeTrackCacheLock to be locked
+static void dfgPruneKeyframeTrackCache()
+{
+  // drop the entries of deleted curves
+  std::map<unsigned int, DFGKeyframeTrackCacheEntry>::iterator it = s_keyframeTrackCache.begin();
+  while(it != s_keyframeTrackCache.end())
+  {
+    if(!it->second.curve.isAlive())
+      s_keyframeTrackCache.erase(it++);
+    else
+      ++it;
+  }
+}
 
-  // find the usage of this plug
-  // with this we might be able to determine color
-  MString curveName = curve.name();
-  double red, green, blue;
-  red = green = blue = 0.0;
-  if(curveName.indexW("_translateX") > -1 || curveName.indexW("_rotateX") > -1 || curveName.indexW("_scaleX") > -1)
-    red = 1.0;
-  else if(curveName.indexW("_translateY") > -1 || curveName.indexW("_rotateY") > -1 || curveName.indexW("_scaleY") > -1)
-    green = 1.0;
-  else if(curveName.indexW("_translateZ") > -1 || curveName.indexW("_rotateZ") > -1 || curveName.indexW("_scaleZ") > -1)
-    blue = 1.0;
+void dfgPlugToPort_KeyframeTrack_invalidate(MObject curveObj)
+{
+  MObjectHandle curveHandle(curveObj);
+  s_keyframeTrackCacheLock.lock();
+  s_keyframeTrackCache.erase(curveHandle.hashCode());
+  dfgPruneKeyframeTrackCache();
+  s_keyframeTrackCacheLock.unlock();
+}
 
-  trackVal = FabricSplice::constructObjectRTVal("KeyframeTrack");
-  FabricCore::RTVal keysVal = trackVal.maybeGetMember("keys");
-  FabricCore::RTVal colorVal = FabricSplice::constructRTVal("Color");
-  FabricCore::RTVal numKeysVal = FabricSplice::constructUInt32RTVal(curve.numKeys());
-  keysVal.callMethod("", "resize", 1, &numKeysVal);
+// the layout of the KL Keyframe struct. the keys are packed on the Maya
+// side and copied into the track's Keyframe[] in one go.
+struct DFGKeyframe
+{
+  float time;
+  float value;
+  float inTangent[2];
+  float outTangent[2];
+  int interpolation;
+};
 
-  trackVal.setMember("name", FabricSplice::constructStringRTVal(curveName.asChar()));
-  colorVal.setMember("r", FabricSplice::constructFloat64RTVal(red));
-  colorVal.setMember("g", FabricSplice::constructFloat64RTVal(green));
-  colorVal.setMember("b", FabricSplice::constructFloat64RTVal(blue));
-  colorVal.setMember("a", FabricSplice::constructFloat64RTVal(1.0));
-  trackVal.setMember("color", colorVal);
-  trackVal.setMember("defaultInterpolation", FabricSplice::constructSInt32RTVal(2));
-  trackVal.setMember("defaultValue", FabricSplice::constructFloat64RTVal(0.0));
+static void dfgPackAnimCurveKeys(MFnAnimCurve & curve, std::vector<DFGKeyframe> & keys)
+{
+  unsigned int numKeys = curve.numKeys();
+  keys.resize(numKeys);
 
   bool weighted = curve.isWeighted();
 
-  for(unsigned int i=0;i<curve.numKeys();i++)
+  double prevKeyTime = 0.0;
+  double keyTime = numKeys > 0 ? curve.time(0).as(MTime::kSeconds) : 0.0;
+  for(unsigned int i=0;i<numKeys;i++)
   {
-    FabricCore::RTVal keyVal = FabricSplice::constructRTVal("Keyframe");
-    FabricCore::RTVal inTangentVal = FabricSplice::constructRTVal("Vec2");
-    FabricCore::RTVal outTangentVal = FabricSplice::constructRTVal("Vec2");
+    DFGKeyframe & key = keys[i];
+    key.inTangent[0] = key.inTangent[1] = 0.0f;
+    key.outTangent[0] = key.outTangent[1] = 0.0f;
+    double nextKeyTime = i < numKeys-1 ? curve.time(i+1).as(MTime::kSeconds) : 0.0;
 
-    // Integer interpolation;
-    double keyTime = curve.time(i).as(MTime::kSeconds);
-    double keyValue = curve.value(i);
-    keyVal.setMember("time", FabricSplice::constructFloat64RTVal(keyTime));
-    keyVal.setMember("value", FabricSplice::constructFloat64RTVal(keyValue));
+    key.time = float(keyTime);
+    key.value = float(curve.value(i));
 
     if(i > 0)
     {
-      double prevKeyTime = curve.time(i-1).as(MTime::kSeconds);
       double timeDelta = keyTime - prevKeyTime;
       
       float x,y;
@@ -2675,15 +3388,13 @@ void dfgPlugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal
         weight = x*weight/timeDelta;
       if(fabs(x) > 0.0001)
         gradient = y/x;
-        //gradient = ((y*1.0/3.0)/valueDelta)/((x*1.0/3.0)/timeDelta);
 
-      inTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(weight));
-      inTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(gradient));
+      key.inTangent[0] = weight;
+      key.inTangent[1] = gradient;
     }
 
-    if(i < curve.numKeys()-1)
+    if(i < numKeys-1)
     {
-      double nextKeyTime = curve.time(i+1).as(MTime::kSeconds);
       double timeDelta = nextKeyTime - keyTime;
       
       float x,y;
@@ -2695,33 +3406,149 @@ void dfgPlugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal
       // Weighted out tangents are defined as 3*(P2 - P1),
       // So multiplly by 1/3 to get P2, and then divide by timeDelta
       // to get the ratio stored by the Fabric Engine keyframes.
-      // Also note that the default value of 1/3 for the handle weight 
-      // will create equally spaced handles, effectively the same as
-      // Maya's non-weighted curves.
       if(weighted && fabs(timeDelta) > 0.0001)
        weight = x*weight/timeDelta;
       if(fabs(x) > 0.0001)
         gradient = y/x;
-        //gradient = ((y*1.0/3.0)/valueDelta)/((x*1.0/3.0)/timeDelta);
 
-      outTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(weight));
-      outTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(gradient));
-    }
+      key.outTangent[0] = weight;
+      key.outTangent[1] = gradient;
+    }
+
+    int interpolation = 2;
+    MFnAnimCurve::TangentType tangentType = curve.outTangentType(i);
+    if(tangentType == MFnAnimCurve::kTangentStep)
+      interpolation = 0;
+    else if(tangentType == MFnAnimCurve::kTangentLinear)
+      interpolation = 1;
+    else if(tangentType == MFnAnimCurve::kTangentStepNext)
+      interpolation = 3;
+    key.interpolation = interpolation;
+
+    prevKeyTime = keyTime;
+    keyTime = nextKeyTime;
+  }
+}
+
+// the keys can only be copied as they are if the KL Keyframe
+// matches DFGKeyframe, otherwise they are set one by one.
+static bool dfgKeyframeLayoutMatches()
+{
+  static int s_matches = -1;
+  if(s_matches < 0)
+  {
+    FabricCore::RTVal keyVal = FabricSplice::constructRTVal("Keyframe");
+    s_matches =
+      FTL::CStrRef(keyVal.maybeGetMember("time").getTypeNameCStr()) == "Float32" &&
+      FTL::CStrRef(keyVal.maybeGetMember("value").getTypeNameCStr()) == "Float32" &&
+      FTL::CStrRef(keyVal.maybeGetMember("inTangent").getTypeNameCStr()) == "Vec2" &&
+      FTL::CStrRef(keyVal.maybeGetMember("outTangent").getTypeNameCStr()) == "Vec2" &&
+      FTL::CStrRef(keyVal.maybeGetMember("interpolation").getTypeNameCStr()) == "SInt32" ? 1 : 0;
+  }
+  return s_matches == 1;
+}
+
+static void dfgSetKeyframes(FabricCore::RTVal & keysVal, const std::vector<DFGKeyframe> & keys)
+{
+  FabricCore::RTVal numKeysVal = FabricSplice::constructUInt32RTVal((unsigned int)keys.size());
+  keysVal.callMethod("", "resize", 1, &numKeysVal);
+  if(keys.size() == 0)
+    return;
+
+  if(dfgKeyframeLayoutMatches())
+  {
+    FabricCore::RTVal dataRtVal = keysVal.callMethod("Data", "data", 0, 0);
+    memcpy(dataRtVal.getData(), &keys[0], sizeof(DFGKeyframe) * keys.size());
+    return;
+  }
 
+  for(size_t i=0;i<keys.size();i++)
+  {
+    const DFGKeyframe & key = keys[i];
+    FabricCore::RTVal keyVal = FabricSplice::constructRTVal("Keyframe");
+    FabricCore::RTVal inTangentVal = FabricSplice::constructRTVal("Vec2");
+    FabricCore::RTVal outTangentVal = FabricSplice::constructRTVal("Vec2");
+    keyVal.setMember("time", FabricSplice::constructFloat64RTVal(key.time));
+    keyVal.setMember("value", FabricSplice::constructFloat64RTVal(key.value));
+    inTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(key.inTangent[0]));
+    inTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(key.inTangent[1]));
+    outTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(key.outTangent[0]));
+    outTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(key.outTangent[1]));
     keyVal.setMember("inTangent", inTangentVal);
     keyVal.setMember("outTangent", outTangentVal);
-    int interpolation = 2;
-    if(curve.outTangentType(i) == MFnAnimCurve::kTangentStep)
-      interpolation = 0;
-    else if(curve.outTangentType(i) == MFnAnimCurve::kTangentLinear)
-      interpolation = 1;
-     else if(curve.outTangentType(i) == MFnAnimCurve::kTangentStepNext)
-      interpolation = 3;
-    keyVal.setMember("interpolation", FabricSplice::constructSInt32RTVal(interpolation));
-    keysVal.setArrayElement(i, keyVal);
+    keyVal.setMember("interpolation", FabricSplice::constructSInt32RTVal(key.interpolation));
+    keysVal.setArrayElement((unsigned int)i, keyVal);
+  }
+}
+
+void dfgPlugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal & trackVal, bool useCache = false) {
+
+  FabricMayaProfilingEvent bracket("dfgPlugToPort_KeyframeTrack_helper");
+
+  MString curveName = curve.name();
+  MObjectHandle curveHandle(curve.object());
+
+  if(useCache)
+  {
+    s_keyframeTrackCacheLock.lock();
+    std::map<unsigned int, DFGKeyframeTrackCacheEntry>::iterator it = s_keyframeTrackCache.find(curveHandle.hashCode());
+    if(it != s_keyframeTrackCache.end() && it->second.curve == curveHandle && it->second.name == curveName)
+      trackVal = it->second.trackVal;
+    s_keyframeTrackCacheLock.unlock();
+    if(trackVal.isValid())
+      return;
+  }
+
+  CORE_CATCH_BEGIN;
+
+  // find the usage of this plug
+  // with this we might be able to determine color
+  double red, green, blue;
+  red = green = blue = 0.0;
+  if(curveName.indexW("_translateX") > -1 || curveName.indexW("_rotateX") > -1 || curveName.indexW("_scaleX") > -1)
+    red = 1.0;
+  else if(curveName.indexW("_translateY") > -1 || curveName.indexW("_rotateY") > -1 || curveName.indexW("_scaleY") > -1)
+    green = 1.0;
+  else if(curveName.indexW("_translateZ") > -1 || curveName.indexW("_rotateZ") > -1 || curveName.indexW("_scaleZ") > -1)
+    blue = 1.0;
+
+  trackVal = FabricSplice::constructObjectRTVal("KeyframeTrack");
+  FabricCore::RTVal colorVal = FabricSplice::constructRTVal("Color");
+
+  trackVal.setMember("name", FabricSplice::constructStringRTVal(curveName.asChar()));
+  colorVal.setMember("r", FabricSplice::constructFloat64RTVal(red));
+  colorVal.setMember("g", FabricSplice::constructFloat64RTVal(green));
+  colorVal.setMember("b", FabricSplice::constructFloat64RTVal(blue));
+  colorVal.setMember("a", FabricSplice::constructFloat64RTVal(1.0));
+  trackVal.setMember("color", colorVal);
+  trackVal.setMember("defaultInterpolation", FabricSplice::constructSInt32RTVal(2));
+  trackVal.setMember("defaultValue", FabricSplice::constructFloat64RTVal(0.0));
+
+  // the keys are packed on the Maya side and
+  // handed over to KL in one go.
+  std::vector<DFGKeyframe> keys;
+  {
+    FabricMayaProfilingEvent bracket("packing keys");
+    dfgPackAnimCurveKeys(curve, keys);
+  }
+
+  {
+    FabricMayaProfilingEvent bracket("setting keys");
+    FabricCore::RTVal keysVal = trackVal.maybeGetMember("keys");
+    dfgSetKeyframes(keysVal, keys);
+    trackVal.setMember("keys", keysVal);
   }
 
-  trackVal.setMember("keys", keysVal);
+  if(useCache)
+  {
+    s_keyframeTrackCacheLock.lock();
+    DFGKeyframeTrackCacheEntry & entry = s_keyframeTrackCache[curveHandle.hashCode()];
+    entry.curve = curveHandle;
+    entry.name = curveName;
+    entry.trackVal = trackVal;
+    dfgPruneKeyframeTrackCache();
+    s_keyframeTrackCacheLock.unlock();
+  }
 
   CORE_CATCH_END;
 }
@@ -2758,8 +3585,9 @@ void dfgPlugToPort_KeyframeTrack(
     if(curve.object().isNull())
       return;
 
+    // IO ports can be modified by the graph, so they don't share the cached tracks
     FabricCore::RTVal trackVal;
-    dfgPlugToPort_KeyframeTrack_helper(curve, trackVal);
+    dfgPlugToPort_KeyframeTrack_helper(curve, trackVal, argOutsidePortType == FabricCore::DFGPortType_In);
     setCB(getSetUD, trackVal.getFECRTValRef());
   } else {
 
@@ -2787,7 +3615,7 @@ void dfgPlugToPort_KeyframeTrack(
         continue;
 
       FabricCore::RTVal trackVal;
-      dfgPlugToPort_KeyframeTrack_helper(curve, trackVal);
+      dfgPlugToPort_KeyframeTrack_helper(curve, trackVal, argOutsidePortType == FabricCore::DFGPortType_In);
 
       trackVals.setArrayElement(j, trackVal);
     }
@@ -2796,6 +3624,22 @@ void dfgPlugToPort_KeyframeTrack(
   }
 }
 
+// the values handed over through FabricSpliceMayaData are shared with the
+// output port of the upstream node, which avoids converting KL objects such
+// as meshes to Maya data and back between two Canvas nodes. In ports only
+// read the shared object. IO ports are cloned eagerly on every transfer, so
+// that the graph cannot modify the upstream value.
+static FabricCore::RTVal dfgSpliceMayaDataValueForPort(FabricCore::RTVal value, FEC_DFGPortType argOutsidePortType)
+{
+  if(argOutsidePortType != FabricCore::DFGPortType_IO)
+    return value;
+  if(!value.isValid() || !value.isObject() || value.isNullObject())
+    return value;
+
+  FabricMayaProfilingEvent bracket("dfgSpliceMayaDataValueForPort clone");
+  return value.callMethod(value.getTypeNameCStr(), "clone", 0, 0);
+}
+
 void dfgPlugToPort_spliceMayaData(
   unsigned argIndex,
   char const *argName,
@@ -2837,7 +3681,8 @@ void dfgPlugToPort_spliceMayaData(
       if(!spliceMayaData)
         return;
 
-      setCB(getSetUD, spliceMayaData->getRTVal().getFECRTValRef());
+      FabricCore::RTVal value = dfgSpliceMayaDataValueForPort(spliceMayaData->getRTVal(), argOutsidePortType);
+      setCB(getSetUD, value.getFECRTValRef());
     }else{
       FTL::AutoProfilingPauseEvent pauseBracket(bracket);
       MArrayDataHandle arrayHandle = data.inputArrayValue(plug);
@@ -2859,7 +3704,7 @@ void dfgPlugToPort_spliceMayaData(
         FabricSpliceMayaData *spliceMayaData = (FabricSpliceMayaData*)mfn.data();
         if(!spliceMayaData)
           return;
-        value.setArrayElement(i, spliceMayaData->getRTVal());
+        value.setArrayElement(i, dfgSpliceMayaDataValueForPort(spliceMayaData->getRTVal(), argOutsidePortType));
       }
 
       setCB(getSetUD, value.getFECRTValRef());
@@ -2892,147 +3737,71 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
 
   valueType = rtVal.callMethod("String", "getValueType", 0, 0).getStringCString();
 
+  DFGCompoundLayout layout = dfgGetCompoundLayout(compound);
+
   // treat special cases
-  if(compound.numChildren() == 3)
+  if(layout.isVec3 || layout.isEuler)
   {
-    MString compoundName = compound.name();
-    FabricCore::RTVal compoundNameRTVal = FabricSplice::constructStringRTVal(compoundName.asChar());
+    FTL::CStrRef typeName = layout.isVec3 ? "Vec3" : "Euler";
+    FTL::CStrRef arrayTypeName = layout.isVec3 ? "Vec3[]" : "Euler[]";
 
-    MFnAttribute x(compound.child(0));
-    MFnAttribute y(compound.child(1));
-    MFnAttribute z(compound.child(2));
-
-    if(x.name() == compoundName+"X" && y.name() == compoundName+"Y" && z.name() == compoundName+"Z")
+    if(!layout.isArray)
     {
-      MStatus attrStatus;
-      MFnNumericAttribute nx(x.object(), &attrStatus);
-      if(attrStatus == MS::kSuccess)
+      if(valueType != typeName)
       {
-        if(!compound.isArray())
-        {
-          if(valueType != "Vec3")
-          {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Vec3Param.");
-            return;
-          }
-
-          FabricCore::RTVal value = rtVal.callMethod("Vec3", "getValue", 0, 0);
-          if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
-            handle.set3Float(
-              (float)dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-              (float)dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-              (float)dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-          } else {
-            handle.set3Double(
-              dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-              dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-              dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-          }
-        }
-        else
-        {
-          if(valueType != "Vec3[]")
-          {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Vec3ArrayParam.");
-            return;
-          }
-
-          MArrayDataHandle arrayHandle(handle);
-          FabricCore::RTVal arrayValue = rtVal.maybeGetMember("values");
-          unsigned int arraySize = arrayValue.getArraySize();
-
-          MArrayDataBuilder arraybuilder = arrayHandle.builder();
-
-          for(unsigned int i = 0; i < arraySize; ++i){
-            FabricCore::RTVal value = rtVal.getArrayElement(i);
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            if(elementHandle.numericType() == MFnNumericData::k3Float || elementHandle.numericType() == MFnNumericData::kFloat){
-              elementHandle.set3Float(
-                (float)dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-                (float)dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-                (float)dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-            } else {
-              elementHandle.set3Double(
-                dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-                dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-                dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-            }
-          }
-          arrayHandle.set(arraybuilder);
-          arrayHandle.setAllClean();
-        }
-
+        mayaLogErrorFunc(MString("Incompatible param for compound attribute - expected a ") + typeName.c_str() + "Param.");
         return;
       }
-      else
+
+      FabricCore::RTVal value = rtVal.callMethod(typeName.c_str(), "getValue", 0, 0);
+      if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
+        handle.set3Float(
+          (float)dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
+          (float)dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
+          (float)dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
+      } else {
+        handle.set3Double(
+          dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
+          dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
+          dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
+      }
+    }
+    else
+    {
+      if(valueType != arrayTypeName)
       {
-        MFnUnitAttribute ux(x.object(), &attrStatus);
-        if(attrStatus == MS::kSuccess)
-        {
-          if(!compound.isArray())
-          {
-            if(valueType != "Euler")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a EulerParam.");
-              return;
-            }
+        mayaLogErrorFunc(MString("Incompatible param for compound attribute - expected a ") + typeName.c_str() + "ArrayParam.");
+        return;
+      }
 
-            FabricCore::RTVal value = rtVal.callMethod("Euler", "getValue", 0, 0);
-            if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
-              handle.set3Float(
-                (float)dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-                (float)dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-                (float)dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-            } else {
-              handle.set3Double(
-                dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-                dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-                dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-            }
-          }
-          else
-          {
-            if(valueType != "Euler[]")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a EulerArrayParam.");
-              return;
-            }
+      // Vec3 and Euler elements both start with three floats
+      unsigned int arraySize = 0;
+      const float * values = (const float *)dfgGetArrayParamData(rtVal, arraySize);
+      size_t stride = layout.isVec3 ? 3 : sizeof(KLEuler) / sizeof(float);
 
-            MArrayDataHandle arrayHandle(handle);
-            FabricCore::RTVal arrayValue = rtVal.maybeGetMember("values");
-            unsigned int arraySize = arrayValue.getArraySize();
-
-            MArrayDataBuilder arraybuilder = arrayHandle.builder();
-
-            for(unsigned int i = 0; i < arraySize; ++i){
-              FabricCore::RTVal value = rtVal.getArrayElement(i);
-              MDataHandle elementHandle = arraybuilder.addElement(i);
-              if(elementHandle.numericType() == MFnNumericData::k3Float || elementHandle.numericType() == MFnNumericData::kFloat){
-                elementHandle.set3Float(
-                  (float)dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-                  (float)dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-                  (float)dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-              } else {
-                elementHandle.set3Double(
-                  dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-                  dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-                  dfgGetFloat64FromRTVal(value.maybeGetMember("z")));
-              }
-            }
-            arrayHandle.set(arraybuilder);
-            arrayHandle.setAllClean();
-          }
+      MArrayDataHandle arrayHandle(handle);
+      MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
-          return;
+      for(unsigned int i = 0; i < arraySize; ++i){
+        const float * value = values + i * stride;
+        MDataHandle elementHandle = arraybuilder.addElement(i);
+        if(elementHandle.numericType() == MFnNumericData::k3Float || elementHandle.numericType() == MFnNumericData::kFloat){
+          elementHandle.set3Float(value[0], value[1], value[2]);
+        } else {
+          elementHandle.set3Double(value[0], value[1], value[2]);
         }
       }
+      arrayHandle.set(arraybuilder);
+      arrayHandle.setAllClean();
     }
+
+    return;
   }
 
-  for(unsigned int i=0;i<compound.numChildren();i++)
+  for(size_t i=0;i<layout.slots.size();i++)
   {
-    MFnAttribute child(compound.child(i));
-    MString childName = child.name();
+    const DFGCompoundSlot & slot = layout.slots[i];
+    const MString & childName = slot.name;
     FabricCore::RTVal childNameRTVal = FabricSplice::constructStringRTVal(childName.asChar());
 
     if(!rtVal.callMethod("Boolean", "hasParam", 1, &childNameRTVal).getBoolean())
@@ -3043,14 +3812,12 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
 
     FabricCore::RTVal childRTVal = rtVal.callMethod("Param", "getParam", 1, &childNameRTVal);
     valueType = childRTVal.callMethod("String", "getValueType", 0, 0).getStringCString();
-    MStatus attrStatus;
 
-    MFnNumericAttribute nAttr(child.object(), &attrStatus);
-    if(attrStatus == MS::kSuccess)
+    switch(slot.type)
     {
-      if(nAttr.unitType() == MFnNumericData::kBoolean)
+      case DFGCompoundSlot_Boolean:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
           if(valueType != "Boolean")
           {
@@ -3059,7 +3826,7 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
           }
 
           childRTVal = rtVal.callMethod("BooleanParam", "getParam", 1, &childNameRTVal);
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           childHandle.setBool(childRTVal.callMethod("Boolean", "getValue", 0, 0).getBoolean());
         }
         else
@@ -3071,23 +3838,25 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
           }
 
           childRTVal = rtVal.callMethod("BooleanArrayParam", "getParam", 1, &childNameRTVal);
-          FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-          MArrayDataHandle childHandle(handle.child(child.object()));
+          unsigned int numElements = 0;
+          const uint8_t * values = (const uint8_t *)dfgGetArrayParamData(childRTVal, numElements);
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
           MArrayDataBuilder arraybuilder = childHandle.builder();
 
-          for(unsigned int j=0;j<arrayValues.getArraySize();j++)
+          for(unsigned int j=0;j<numElements;j++)
           {
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            elementHandle.setBool(arrayValues.getArrayElement(i).getBoolean());
+            MDataHandle elementHandle = arraybuilder.addElement(j);
+            elementHandle.setBool(values[j] != 0);
           }
 
           childHandle.set(arraybuilder);
           childHandle.setAllClean();
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::kInt)
+      case DFGCompoundSlot_SInt32:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
           if(valueType != "SInt32")
           {
@@ -3096,7 +3865,7 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
           }
 
           childRTVal = rtVal.callMethod("SInt32Param", "getParam", 1, &childNameRTVal);
-          MDataHandle childHandle(handle.child(child.object()));
+          MDataHandle childHandle(handle.child(slot.attribute));
           childHandle.setInt(childRTVal.callMethod("SInt32", "getValue", 0, 0).getSInt32());
         }
         else
@@ -3108,23 +3877,27 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
           }
 
           childRTVal = rtVal.callMethod("SInt32ArrayParam", "getParam", 1, &childNameRTVal);
-          FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-          MArrayDataHandle childHandle(handle.child(child.object()));
+          unsigned int numElements = 0;
+          const int32_t * values = (const int32_t *)dfgGetArrayParamData(childRTVal, numElements);
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
           MArrayDataBuilder arraybuilder = childHandle.builder();
 
-          for(unsigned int j=0;j<arrayValues.getArraySize();j++)
+          for(unsigned int j=0;j<numElements;j++)
           {
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            elementHandle.setInt(arrayValues.getArrayElement(i).getSInt32());
+            MDataHandle elementHandle = arraybuilder.addElement(j);
+            elementHandle.setInt(values[j]);
           }
 
           childHandle.set(arraybuilder);
           childHandle.setAllClean();
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::kFloat)
+      case DFGCompoundSlot_Float32:
+      case DFGCompoundSlot_Float64:
       {
-        if(!nAttr.isArray())
+        bool isFloat = slot.type == DFGCompoundSlot_Float32;
+        if(!slot.isArray)
         {
           if(valueType != "Float64")
           {
@@ -3133,8 +3906,12 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
           }
 
           childRTVal = rtVal.callMethod("Float64Param", "getParam", 1, &childNameRTVal);
-          MDataHandle childHandle(handle.child(child.object()));
-          childHandle.setFloat(childRTVal.callMethod("Float64", "getValue", 0, 0).getFloat64());
+          MDataHandle childHandle(handle.child(slot.attribute));
+          double value = childRTVal.callMethod("Float64", "getValue", 0, 0).getFloat64();
+          if(isFloat)
+            childHandle.setFloat((float)value);
+          else
+            childHandle.setDouble(value);
         }
         else
         {
@@ -3145,364 +3922,271 @@ void dfgPortToPlug_compound_convertCompound(MFnCompoundAttribute & compound, MDa
           }
 
           childRTVal = rtVal.callMethod("Float64ArrayParam", "getParam", 1, &childNameRTVal);
-          FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-          MArrayDataHandle childHandle(handle.child(child.object()));
+          unsigned int numElements = 0;
+          const double * values = (const double *)dfgGetArrayParamData(childRTVal, numElements);
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
           MArrayDataBuilder arraybuilder = childHandle.builder();
 
-          for(unsigned int j=0;j<arrayValues.getArraySize();j++)
+          for(unsigned int j=0;j<numElements;j++)
           {
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            elementHandle.setFloat(arrayValues.getArrayElement(i).getFloat64());
+            MDataHandle elementHandle = arraybuilder.addElement(j);
+            if(isFloat)
+              elementHandle.setFloat((float)values[j]);
+            else
+              elementHandle.setDouble(values[j]);
           }
 
           childHandle.set(arraybuilder);
           childHandle.setAllClean();
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::kDouble)
+      case DFGCompoundSlot_Vec3:
+      case DFGCompoundSlot_Color:
       {
-        if(!nAttr.isArray())
+        bool isColor = slot.type == DFGCompoundSlot_Color;
+        if(!slot.isArray)
         {
-          if(valueType != "Float64")
+          if(valueType != FTL::CStrRef(isColor ? "Color" : "Vec3"))
           {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Float64Param.");
+            mayaLogErrorFunc(isColor ?
+              "Incompatible param for compound attribute - expected a ColorParam." :
+              "Incompatible param for compound attribute - expected a Vec3Param.");
             return;
           }
 
-          childRTVal = rtVal.callMethod("Float64Param", "getParam", 1, &childNameRTVal);
-          MDataHandle childHandle(handle.child(child.object()));
-          childHandle.setDouble(childRTVal.callMethod("Float64", "getValue", 0, 0).getFloat64());
+          childRTVal = rtVal.callMethod(isColor ? "ColorParam" : "Vec3Param", "getParam", 1, &childNameRTVal);
+          MDataHandle childHandle(handle.child(slot.attribute));
+
+          FabricCore::RTVal value = childRTVal.maybeGetMember("value");
+          MFloatVector v(
+            dfgGetFloat64FromRTVal(value.maybeGetMember(isColor ? "r" : "x")),
+            dfgGetFloat64FromRTVal(value.maybeGetMember(isColor ? "g" : "y")),
+            dfgGetFloat64FromRTVal(value.maybeGetMember(isColor ? "b" : "z"))
+          );
+          childHandle.setMFloatVector(v);
         }
         else
         {
-          if(valueType != "Float64[]")
+          if(valueType != FTL::CStrRef(isColor ? "Color[]" : "Vec3[]"))
           {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Float64ArrayParam.");
+            mayaLogErrorFunc(isColor ?
+              "Incompatible param for compound attribute - expected a ColorArrayParam." :
+              "Incompatible param for compound attribute - expected a Vec3ArrayParam.");
             return;
           }
 
-          childRTVal = rtVal.callMethod("Float64ArrayParam", "getParam", 1, &childNameRTVal);
-          FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-          MArrayDataHandle childHandle(handle.child(child.object()));
+          childRTVal = rtVal.callMethod(isColor ? "ColorArrayParam" : "Vec3ArrayParam", "getParam", 1, &childNameRTVal);
+          unsigned int numElements = 0;
+          const float * values = (const float *)dfgGetArrayParamData(childRTVal, numElements);
+          size_t stride = isColor ? 4 : 3;
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
           MArrayDataBuilder arraybuilder = childHandle.builder();
 
-          for(unsigned int j=0;j<arrayValues.getArraySize();j++)
+          for(unsigned int j=0;j<numElements;j++)
           {
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            elementHandle.setDouble(arrayValues.getArrayElement(i).getFloat64());
+            const float * value = values + j * stride;
+            MDataHandle elementHandle = arraybuilder.addElement(j);
+            elementHandle.setMFloatVector(MFloatVector(value[0], value[1], value[2]));
           }
 
           childHandle.set(arraybuilder);
           childHandle.setAllClean();
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::k3Double) // vec3
+      case DFGCompoundSlot_String:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
-          if(valueType != "Vec3")
+          if(valueType != "String")
           {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Vec3Param.");
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a String=Param.");
             return;
           }
 
-          childRTVal = rtVal.callMethod("Vec3Param", "getParam", 1, &childNameRTVal);
-          MDataHandle childHandle(handle.child(child.object()));
+          childRTVal = rtVal.callMethod("StringParam", "getParam", 1, &childNameRTVal);
+          MDataHandle childHandle(handle.child(slot.attribute));
 
           FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-          MFloatVector v(
-            dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-            dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-            dfgGetFloat64FromRTVal(value.maybeGetMember("z"))
-          );
-          childHandle.setMFloatVector(v);
+          childHandle.setString(value.getStringCString());
         }
         else
         {
-          if(valueType != "Vec3[]")
+          if(valueType != "String[]")
           {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Vec3ArrayParam.");
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a StringArrayParam.");
             return;
           }
 
-          childRTVal = rtVal.callMethod("Vec3ArrayParam", "getParam", 1, &childNameRTVal);
-          FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-          MArrayDataHandle childHandle(handle.child(child.object()));
+          childRTVal = rtVal.callMethod("StringArrayParam", "getParam", 1, &childNameRTVal);
+          FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
           MArrayDataBuilder arraybuilder = childHandle.builder();
 
-          for(unsigned int j=0;j<arrayValues.getArraySize();j++)
+          for(unsigned int j=0;j<valuesRTVal.getArraySize();j++)
           {
-            FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-            MFloatVector v(
-              dfgGetFloat64FromRTVal(value.maybeGetMember("x")),
-              dfgGetFloat64FromRTVal(value.maybeGetMember("y")),
-              dfgGetFloat64FromRTVal(value.maybeGetMember("z"))
-            );
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            elementHandle.setMFloatVector(v);
+            FabricCore::RTVal valueRT = valuesRTVal.getArrayElement(j);
+            MDataHandle elementHandle = arraybuilder.addElement(j);
+            elementHandle.setString(valueRT.getStringCString());
           }
 
           childHandle.set(arraybuilder);
           childHandle.setAllClean();
         }
+        break;
       }
-      else if(nAttr.unitType() == MFnNumericData::k3Float) // color
+      case DFGCompoundSlot_IntArrayData:
       {
-        if(!nAttr.isArray())
+        if(!slot.isArray)
         {
-          if(valueType != "Color")
+          if(valueType != "SInt32[]")
           {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a ColorParam.");
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a SInt32ArrayParam.");
             return;
           }
 
-          childRTVal = rtVal.callMethod("ColorParam", "getParam", 1, &childNameRTVal);
-          MDataHandle childHandle(handle.child(child.object()));
+          childRTVal = rtVal.callMethod("SInt32ArrayParam", "getParam", 1, &childNameRTVal);
+          unsigned int numElements = 0;
+          const int * values = (const int *)dfgGetArrayParamData(childRTVal, numElements);
 
-          FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-          MFloatVector v(
-            dfgGetFloat64FromRTVal(value.maybeGetMember("r")),
-            dfgGetFloat64FromRTVal(value.maybeGetMember("g")),
-            dfgGetFloat64FromRTVal(value.maybeGetMember("b"))
-          );
-          childHandle.setMFloatVector(v);
+          MDataHandle childHandle(handle.child(slot.attribute));
+          childHandle.set(MFnIntArrayData().create(MIntArray(values, numElements)));
         }
         else
         {
-          if(valueType != "Color[]")
+          mayaLogErrorFunc("Arrays of MFnData::kIntArray are not supported for '"+childName+"'.");
+        }
+        break;
+      }
+      case DFGCompoundSlot_DoubleArrayData:
+      {
+        if(!slot.isArray)
+        {
+          if(valueType != "Float64[]")
           {
-            mayaLogErrorFunc("Incompatible param for compound attribute - expected a ColorArrayParam.");
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Float64ArrayParam.");
             return;
           }
 
-          childRTVal = rtVal.callMethod("ColorArrayParam", "getParam", 1, &childNameRTVal);
-          FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-          MArrayDataHandle childHandle(handle.child(child.object()));
-          MArrayDataBuilder arraybuilder = childHandle.builder();
-
-          for(unsigned int j=0;j<arrayValues.getArraySize();j++)
-          {
-            FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-            MFloatVector v(
-              dfgGetFloat64FromRTVal(value.maybeGetMember("r")),
-              dfgGetFloat64FromRTVal(value.maybeGetMember("g")),
-              dfgGetFloat64FromRTVal(value.maybeGetMember("b"))
-            );
-            MDataHandle elementHandle = arraybuilder.addElement(i);
-            elementHandle.setMFloatVector(v);
-          }
+          childRTVal = rtVal.callMethod("Float64ArrayParam", "getParam", 1, &childNameRTVal);
+          unsigned int numElements = 0;
+          const double * values = (const double *)dfgGetArrayParamData(childRTVal, numElements);
 
-          childHandle.set(arraybuilder);
-          childHandle.setAllClean();
+          MDataHandle childHandle(handle.child(slot.attribute));
+          childHandle.set(MFnDoubleArrayData().create(MDoubleArray(values, numElements)));
         }
+        else
+        {
+          mayaLogErrorFunc("Arrays of MFnData::kDoubleArray are not supported for '"+childName+"'.");
+        }
+        break;
       }
-      else
-      {
-        mayaLogErrorFunc("Unsupported numeric attribute '"+childName+"'.");
-        return;
-      }
-    }
-    else
-    {
-      MFnTypedAttribute tAttr(child.object(), &attrStatus);
-      if(attrStatus == MS::kSuccess)
+      case DFGCompoundSlot_VectorArrayData:
       {
-        if(tAttr.attrType() == MFnData::kString)
+        if(!slot.isArray)
         {
-          if(!tAttr.isArray())
+          if(valueType != "Vec3[]")
           {
-            if(valueType != "String")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a String=Param.");
-              return;
-            }
-
-            childRTVal = rtVal.callMethod("StringParam", "getParam", 1, &childNameRTVal);
-            MDataHandle childHandle(handle.child(child.object()));
-
-            FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-            childHandle.setString(value.getStringCString());
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Vec3ArrayParam.");
+            return;
           }
-          else
-          {
-           if(valueType != "String[]")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a StringArrayParam.");
-              return;
-            }
 
-            childRTVal = rtVal.callMethod("StringArrayParam", "getParam", 1, &childNameRTVal);
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            MArrayDataHandle childHandle(handle.child(child.object()));
-            MArrayDataBuilder arraybuilder = childHandle.builder();
+          childRTVal = rtVal.callMethod("Vec3ArrayParam", "getParam", 1, &childNameRTVal);
+          unsigned int numElements = 0;
+          const float * values = (const float *)dfgGetArrayParamData(childRTVal, numElements);
 
-            for(unsigned int j=0;j<valuesRTVal.getArraySize();j++)
-            {
-              FabricCore::RTVal valueRT = valuesRTVal.getArrayElement(j);
-              MDataHandle elementHandle = arraybuilder.addElement(j);
-              elementHandle.setString(valueRT.getStringCString());
-            }
+          MVectorArray arrayValues;
+          arrayValues.setLength(numElements);
+          if(numElements > 0)
+            dfgWidenFloat32ToFloat64(values, &arrayValues[0].x, numElements * 3);
 
-            childHandle.set(arraybuilder);
-            childHandle.setAllClean();
-          }
+          MDataHandle childHandle(handle.child(slot.attribute));
+          childHandle.set(MFnVectorArrayData().create(arrayValues));
         }
-        else if(tAttr.attrType() == MFnData::kIntArray)
+        else
         {
-          if(!tAttr.isArray())
-          {
-            if(valueType != "SInt32[]")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a SInt32ArrayParam.");
-              return;
-            }
-
-            MArrayDataHandle childHandle(handle.child(child.object()));
-
-            childRTVal = rtVal.callMethod("SInt32ArrayParam", "getParam", 1, &childNameRTVal);
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
-
-            MIntArray arrayValues;
-            arrayValues.setLength(valuesRTVal.getArraySize());
-            memcpy(&arrayValues[0], dataRtVal.getData(), sizeof(int32_t) * arrayValues.length());
-            handle.set(MFnIntArrayData().create(arrayValues));
-          }
-          else
-          {
-            mayaLogErrorFunc("Arrays of MFnData::kIntArray are not supported for '"+childName+"'.");
-          }
+          mayaLogErrorFunc("Arrays of MFnData::kVectorArray are not supported for '"+childName+"'.");
         }
-        else if(tAttr.attrType() == MFnData::kDoubleArray)
+        break;
+      }
+      case DFGCompoundSlot_Mat44:
+      {
+        if(!slot.isArray)
         {
-          if(!tAttr.isArray())
+          if(valueType != "Mat44")
           {
-            if(valueType != "Float64[]")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a Float64ArrayParam.");
-              return;
-            }
-
-            MArrayDataHandle childHandle(handle.child(child.object()));
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Mat44Param.");
+            return;
+          }
 
-            childRTVal = rtVal.callMethod("Float64ArrayParam", "getParam", 1, &childNameRTVal);
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
+          childRTVal = rtVal.callMethod("Mat44Param", "getParam", 1, &childNameRTVal);
+          MDataHandle childHandle(handle.child(slot.attribute));
 
-            MDoubleArray arrayValues;
-            arrayValues.setLength(valuesRTVal.getArraySize());
-            memcpy(&arrayValues[0], dataRtVal.getData(), sizeof(double) * arrayValues.length());
-            handle.set(MFnDoubleArrayData().create(arrayValues));
-          }
-          else
-          {
-            mayaLogErrorFunc("Arrays of MFnData::kDoubleArray are not supported for '"+childName+"'.");
-          }
+          FabricCore::RTVal value = childRTVal.maybeGetMember("value");
+          MMatrix m;
+          dfgPortToPlug_compound_convertMat44(m, value);
+          childHandle.setMMatrix(m);
         }
-        else if(tAttr.attrType() == MFnData::kVectorArray)
+        else
         {
-          if(!tAttr.isArray())
+          if(valueType != "Mat44[]")
           {
-            if(valueType != "Vec3[]")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a Vec3ArrayParam.");
-              return;
-            }
-
-            MArrayDataHandle childHandle(handle.child(child.object()));
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a Mat44ArrayParam.");
+            return;
+          }
 
-            childRTVal = rtVal.callMethod("Vec3ArrayParam", "getParam", 1, &childNameRTVal);
-            FabricCore::RTVal valuesRTVal = childRTVal.maybeGetMember("values");
-            FabricCore::RTVal dataRtVal = valuesRTVal.callMethod("Data", "data", 0, 0);
-            floatVec * data = (floatVec *)dataRtVal.getData();
+          childRTVal = rtVal.callMethod("Mat44ArrayParam", "getParam", 1, &childNameRTVal);
+          unsigned int numElements = 0;
+          const float * values = (const float *)dfgGetArrayParamData(childRTVal, numElements);
 
-            MVectorArray arrayValues;
-            arrayValues.setLength(valuesRTVal.getArraySize());
+          std::vector<double> staging(numElements * 16);
+          if(numElements > 0)
+            dfgTransposeMat44(values, &staging[0], numElements);
 
-            for(uint32_t i=0;i<arrayValues.length();i++)
-              arrayValues.set(data[i], i);
+          MArrayDataHandle childHandle(handle.child(slot.attribute));
+          MArrayDataBuilder arraybuilder = childHandle.builder();
 
-            handle.set(MFnVectorArrayData().create(arrayValues));
-          }
-          else
+          for(unsigned int j=0;j<numElements;j++)
           {
-            mayaLogErrorFunc("Arrays of MFnData::kVectorArray are not supported for '"+childName+"'.");
+            MDataHandle elementHandle = arraybuilder.addElement(j);
+            elementHandle.setMMatrix(MMatrix((const double (*)[4])&staging[j * 16]));
           }
+
+          childHandle.set(arraybuilder);
+          childHandle.setAllClean();
         }
-        else
-        {
-          mayaLogErrorFunc("Unsupported typed attribute '"+childName+"'.");
-          return;
-        }
+        break;
       }
-      else
+      case DFGCompoundSlot_Compound:
       {
-        MFnMatrixAttribute mAttr(child.object(), &attrStatus);
-        if(attrStatus == MS::kSuccess)
+        if(!slot.isArray)
         {
-          if(!mAttr.isArray())
+          if(valueType != "Compound")
           {
-            if(valueType != "Mat44")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a Mat44Param.");
-              return;
-            }
-
-            childRTVal = rtVal.callMethod("Mat44Param", "getParam", 1, &childNameRTVal);
-            MDataHandle childHandle(handle.child(child.object()));
-
-            FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-            MMatrix m;
-            dfgPortToPlug_compound_convertMat44(m, value);
-            childHandle.setMMatrix(m);
+            mayaLogErrorFunc("Incompatible param for compound attribute - expected a CompoundParam.");
+            return;
           }
-          else
-          {
-            if(valueType != "Mat44[]")
-            {
-              mayaLogErrorFunc("Incompatible param for compound attribute - expected a Mat44ArrayParam.");
-              return;
-            }
-
-            childRTVal = rtVal.callMethod("Mat44ArrayParam", "getParam", 1, &childNameRTVal);
-            FabricCore::RTVal arrayValues = childRTVal.maybeGetMember("values");
-            MArrayDataHandle childHandle(handle.child(child.object()));
-            MArrayDataBuilder arraybuilder = childHandle.builder();
-
-            for(unsigned int j=0;j<arrayValues.getArraySize();j++)
-            {
-              FabricCore::RTVal value = childRTVal.maybeGetMember("value");
-              MDataHandle elementHandle = arraybuilder.addElement(i);
-              MMatrix m;
-              dfgPortToPlug_compound_convertMat44(m, value);
-              elementHandle.setMMatrix(m);
-            }
 
-            childHandle.set(arraybuilder);
-            childHandle.setAllClean();
-          }
-        }
-        else
-        {
-          MFnCompoundAttribute cAttr(child.object(), &attrStatus);
-          if(attrStatus == MS::kSuccess)
-          {
-            MFnCompoundAttribute cAttr(compound.child(i));
-            if(!cAttr.isArray())
-            {
-              if(valueType != "Compound")
-              {
-                mayaLogErrorFunc("Incompatible param for compound attribute - expected a CompoundParam.");
-                return;
-              }
-
-              MDataHandle childHandle(handle.child(child.object()));
-              childRTVal = rtVal.callMethod("CompoundParam", "getParam", 1, &childNameRTVal);
-              dfgPortToPlug_compound_convertCompound(cAttr, childHandle, childRTVal);
-            }
-          }
+          MFnCompoundAttribute cAttr(slot.attribute);
+          MDataHandle childHandle(handle.child(slot.attribute));
+          childRTVal = rtVal.callMethod("CompoundParam", "getParam", 1, &childNameRTVal);
+          dfgPortToPlug_compound_convertCompound(cAttr, childHandle, childRTVal);
         }
+        break;
+      }
+      case DFGCompoundSlot_UnsupportedNumeric:
+      {
+        mayaLogErrorFunc("Unsupported numeric attribute '"+childName+"'.");
+        return;
+      }
+      case DFGCompoundSlot_UnsupportedTyped:
+      {
+        mayaLogErrorFunc("Unsupported typed attribute '"+childName+"'.");
+        return;
       }
+      default:
+        break;
     }
   }
 
@@ -3755,11 +4439,7 @@ void dfgPortToPlug_integer(
       // bool isNativeArray = FTL::CStrRef(binding.getExec().getExecPortMetadata(argName, "nativeArray")) == "true";
       if(MFnTypedAttribute(plug.attribute()).attrType() == MFnData::kIntArray) {// || isNativeArray) {
 
-        MIntArray arrayValues;
-        arrayValues.setLength(numElements);
-        for(unsigned int i = 0; i < numElements; ++i)
-          arrayValues[i] = values[i];
-
+        MIntArray arrayValues((const int *)values, (unsigned int)numElements);
         handle.set(MFnIntArrayData().create(arrayValues));
       }else{
         handle.setInt(values[0]);
@@ -3792,11 +4472,7 @@ void dfgPortToPlug_integer(
       // bool isNativeArray = FTL::CStrRef(binding.getExec().getExecPortMetadata(argName, "nativeArray")) == "true";
       if(MFnTypedAttribute(plug.attribute()).attrType() == MFnData::kIntArray) {// || isNativeArray) {
 
-        MIntArray arrayValues;
-        arrayValues.setLength(numElements);
-        for(unsigned int i = 0; i < numElements; ++i)
-          arrayValues[i] = values[i];
-
+        MIntArray arrayValues((const int *)values, (unsigned int)numElements);
         handle.set(MFnIntArrayData().create(arrayValues));
       }else{
         handle.setInt(values[0]);
@@ -3944,20 +4620,18 @@ void dfgPortToPlug_scalar(
   }
   else{
     MDataHandle handle = data.outputValue(plug);
-    if(numElements > 1) {
+    if(handle.type() == MFnData::kDoubleArray) {
 
       MDoubleArray mayaDoubleValues;
-      mayaDoubleValues.setLength(numElements);
-
       if(isDouble)
       {
-        for(unsigned int i=0;i<numElements;i++)
-          mayaDoubleValues[i] = doubleValues[i];
+        mayaDoubleValues = MDoubleArray(doubleValues, (unsigned int)numElements);
       }
       else
       {
-        for(unsigned int i=0;i<numElements;i++)
-          mayaDoubleValues[i] = floatValues[i];
+        mayaDoubleValues.setLength(numElements);
+        if(numElements > 0)
+          dfgWidenFloat32ToFloat64(floatValues, &mayaDoubleValues[0], numElements);
       }
 
       handle.set(MFnDoubleArrayData().create(mayaDoubleValues));
@@ -4059,7 +4733,17 @@ void dfgPortToPlug_color(
   else{
     MDataHandle handle = data.outputValue(plug);
 
-    if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
+    if(handle.type() == MFnData::kVectorArray){
+      MVectorArray arrayValues;
+      arrayValues.setLength(numElements);
+      for(unsigned int i = 0; i < numElements; ++i){
+        arrayValues[i].x = values[offset+0];
+        arrayValues[i].y = values[offset+1];
+        arrayValues[i].z = values[offset+2];
+        offset += 4;
+      }
+      handle.set(MFnVectorArrayData().create(arrayValues));
+    }else if(handle.numericType() == MFnNumericData::k3Float || handle.numericType() == MFnNumericData::kFloat){
       MFloatVector v(
         (float)values[offset+0], 
         (float)values[offset+1], 
@@ -4255,6 +4939,8 @@ void dfgPortToPlug_vec3(
     MArrayDataHandle arrayHandle = data.outputArrayValue(plug);
     MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
+    // widened lazily, only needed for double precision elements
+    std::vector<double> staging;
     for(unsigned int i = 0; i < numElements; ++i){
       MDataHandle handle = arraybuilder.addElement(i);
 
@@ -4265,10 +4951,15 @@ void dfgPortToPlug_vec3(
           (float)values[offset+2]
         );
       } else {
+        if(staging.empty())
+        {
+          staging.resize(numElements * 3);
+          dfgWidenFloat32ToFloat64(values, &staging[0], numElements * 3);
+        }
         handle.set3Double(
-          values[offset+0], 
-          values[offset+1], 
-          values[offset+2]
+          staging[offset+0], 
+          staging[offset+1], 
+          staging[offset+2]
         );
       }
       offset+=3;
@@ -4282,24 +4973,20 @@ void dfgPortToPlug_vec3(
     // todo: nativeArray metadata support
     if(handle.type() == MFnData::kVectorArray) {
 
+      // MVector is three packed doubles, widen the whole array in one go
       MVectorArray arrayValues;
       arrayValues.setLength(numElements);
-      for(unsigned int i = 0; i < numElements; ++i){
-        arrayValues[i].x = values[offset++];
-        arrayValues[i].y = values[offset++];
-        arrayValues[i].z = values[offset++];
-      }
+      if(numElements > 0)
+        dfgWidenFloat32ToFloat64(values, &arrayValues[0].x, numElements * 3);
 
       handle.set(MFnVectorArrayData().create(arrayValues));
     }else if(handle.type() == MFnData::kPointArray) {
 
+      // MPoint is four packed doubles, w keeps its default of 1
       MPointArray arrayValues;
       arrayValues.setLength(numElements);
-      for(unsigned int i = 0; i < numElements; ++i){
-        arrayValues[i].x = values[offset++];
-        arrayValues[i].y = values[offset++];
-        arrayValues[i].z = values[offset++];
-      }
+      if(numElements > 0)
+        dfgPackFloat32x3ToFloat64x4(values, &arrayValues[0].x, numElements);
 
       handle.set(MFnPointArrayData().create(arrayValues));
     }else{
@@ -4390,35 +5077,22 @@ void dfgPortToPlug_vec3_float64(
   }
   else{
     MDataHandle handle = data.outputValue(plug);
-    if(handle.numericType() != MFnNumericData::k3Double && handle.numericType() != MFnNumericData::kDouble)
-      return;
-
-    // todo: nativeArray metadata support
     if(handle.type() == MFnData::kVectorArray) 
     {
-      MVectorArray arrayValues;
-      arrayValues.setLength(numElements);
-      for(unsigned int i = 0; i < numElements; ++i)
-      {
-        arrayValues[i].x = values[elementSize*i + 0];
-        arrayValues[i].y = values[elementSize*i + 1];
-        arrayValues[i].z = values[elementSize*i + 2];
-      }
+      // MVector is three packed doubles, same layout as Vec3_d
+      MVectorArray arrayValues((const double (*)[3])values, (unsigned int)numElements);
       handle.set(MFnVectorArrayData().create(arrayValues));
     }
     else if(handle.type() == MFnData::kPointArray) 
     {
+      // MPoint is four packed doubles, w keeps its default of 1
       MPointArray arrayValues;
-      arrayValues.setLength(numElements);
-      for(unsigned int i = 0; i < numElements; ++i)
-      {
-        arrayValues[i].x = values[elementSize*i + 0];
-        arrayValues[i].y = values[elementSize*i + 1];
-        arrayValues[i].z = values[elementSize*i + 2];
-      }
+      arrayValues.setLength((unsigned int)numElements);
+      if(numElements > 0)
+        dfgPackFloat64x3ToFloat64x4(values, &arrayValues[0].x, numElements);
       handle.set(MFnPointArrayData().create(arrayValues));
     } 
-    else
+    else if(handle.numericType() == MFnNumericData::k3Double || handle.numericType() == MFnNumericData::kDouble)
     {
       handle.set3Double(values[0], values[1], values[2]);
     }
@@ -4622,27 +5296,25 @@ void dfgPortToPlug_mat44(
     MArrayDataHandle arrayHandle = data.outputArrayValue(plug);
     MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
-    unsigned int offset = 0;
+    // convert the whole array in one pass, then scatter it into the builder
     if(isFloatMatrix)
     {
+      std::vector<float> staging(numElements * 16);
+      if(numElements > 0)
+        dfgTransposeMat44(values, &staging[0], numElements);
       for(unsigned int i = 0; i < numElements; ++i){
         MDataHandle handle = arraybuilder.addElement(i);
-
-        MFloatMatrix mayaMat;
-        Mat44ToMFloatMatrix_data(&values[offset], mayaMat);
-        handle.setMFloatMatrix(mayaMat);
-        offset += 16;
+        handle.setMFloatMatrix(MFloatMatrix((const float (*)[4])&staging[i * 16]));
       }
-    } // double
+    }
     else
     {
+      std::vector<double> staging(numElements * 16);
+      if(numElements > 0)
+        dfgTransposeMat44(values, &staging[0], numElements);
       for(unsigned int i = 0; i < numElements; ++i){
         MDataHandle handle = arraybuilder.addElement(i);
-
-        MMatrix mayaMat;
-        Mat44ToMMatrix_data(&values[offset], mayaMat);
-        handle.setMMatrix(mayaMat);
-        offset += 16;
+        handle.setMMatrix(MMatrix((const double (*)[4])&staging[i * 16]));
       }
     }
 
@@ -4694,25 +5366,25 @@ void dfgPortToPlug_mat44_float64(
     MArrayDataHandle arrayHandle = data.outputArrayValue(plug);
     MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
-    unsigned int offset = 0;
+    // convert the whole array in one pass, then scatter it into the builder
     if(isFloatMatrix)
     {
+      std::vector<float> staging(numElements * 16);
+      if(numElements > 0)
+        dfgTransposeMat44(values, &staging[0], numElements);
       for(unsigned int i = 0; i < numElements; ++i){
         MDataHandle handle = arraybuilder.addElement(i);
-        MFloatMatrix mayaMat;
-        Mat44ToMFloatMatrix_data(&values[offset], mayaMat);
-        handle.setMFloatMatrix(mayaMat);
-        offset += 16;
+        handle.setMFloatMatrix(MFloatMatrix((const float (*)[4])&staging[i * 16]));
       }
     }
     else
     {
+      std::vector<double> staging(numElements * 16);
+      if(numElements > 0)
+        dfgTransposeMat44(values, &staging[0], numElements);
       for(unsigned int i = 0; i < numElements; ++i){
         MDataHandle handle = arraybuilder.addElement(i);
-        MMatrix mayaMat;
-        Mat44ToMMatrix_data(&values[offset], mayaMat);
-        handle.setMMatrix(mayaMat);
-        offset += 16;
+        handle.setMMatrix(MMatrix((const double (*)[4])&staging[i * 16]));
       }
     }
 
@@ -4737,25 +5409,106 @@ void dfgPortToPlug_mat44_float64(
   }
 }
 
-MObject dfgPolygonMeshToMFnMesh(FabricCore::RTVal rtMesh, bool insideCompute)
+// the data of a PolygonMesh fetched from KL, so
+// that several meshes can be built concurrently.
+struct DFGPolygonMeshOutputData
 {
-  MObject result;
-  CORE_CATCH_BEGIN;
+  unsigned int nbPoints;
+  unsigned int nbPolygons;
+  unsigned int nbSamples;
+
+  MPointArray  points;
+  MVectorArray normals;
+  MIntArray    counts;
+  MIntArray    indices;
+
+  bool hasUVs;
+  MFloatArray uvValues;
+
+  bool hasColors;
+  MColorArray colors;
+
+  MObject meshObject;
+
+  DFGPolygonMeshOutputData()
+  : nbPoints(0)
+  , nbPolygons(0)
+  , nbSamples(0)
+  , hasUVs(false)
+  , hasColors(false)
+  {}
+};
+
+static void dfgFetchPolygonMeshData(FabricCore::RTVal rtMesh, DFGPolygonMeshOutputData & meshData)
+{
+  if(rtMesh.isNullObject())
+    return;
+
+  meshData.nbPoints   = rtMesh.callMethod("UInt64", "pointCount",         0, 0).getUInt64();
+  meshData.nbPolygons = rtMesh.callMethod("UInt64", "polygonCount",       0, 0).getUInt64();
+  meshData.nbSamples  = rtMesh.callMethod("UInt64", "polygonPointsCount", 0, 0).getUInt64();
+
+  #if MAYA_API_VERSION < 201500         // FE-5118 ("crash when saving scene with an empty polygon mesh")
+  if (meshData.nbPoints < 3 || meshData.nbPolygons == 0)
+    return;
+  #endif
+
+  meshData.points.setLength(meshData.nbPoints);
+  if(meshData.points.length() > 0)
+  {
+    std::vector<FabricCore::RTVal> args(2);
+    args[0] = FabricSplice::constructExternalArrayRTVal("Float64", meshData.points.length() * 4, &meshData.points[0]);
+    args[1] = FabricSplice::constructUInt32RTVal(4); // components
+    rtMesh.callMethod("", "getPointsAsExternalArray_d", 2, &args[0]);
+  }
 
-  unsigned int nbPoints   = 0;
-  unsigned int nbPolygons = 0;
-  unsigned int nbSamples  = 0;
-  if(!rtMesh.isNullObject())
+  meshData.normals.setLength(meshData.nbSamples);
+  if(meshData.normals.length() > 0)
   {
-    nbPoints   = rtMesh.callMethod("UInt64", "pointCount",         0, 0).getUInt64();
-    nbPolygons = rtMesh.callMethod("UInt64", "polygonCount",       0, 0).getUInt64();
-    nbSamples  = rtMesh.callMethod("UInt64", "polygonPointsCount", 0, 0).getUInt64();
+    FabricCore::RTVal normalsVar = 
+    FabricSplice::constructExternalArrayRTVal("Float64", meshData.normals.length() * 3, &meshData.normals[0]);
+    rtMesh.callMethod("", "getNormalsAsExternalArray_d", 1, &normalsVar);
+  }
+
+  meshData.counts.setLength(meshData.nbPolygons);
+  meshData.indices.setLength(meshData.nbSamples);
+  if(meshData.counts.length() > 0 && meshData.indices.length() > 0)
+  {
+    std::vector<FabricCore::RTVal> args(2);
+    args[0] = FabricSplice::constructExternalArrayRTVal("UInt32", meshData.counts.length(),  &meshData.counts[0]);
+    args[1] = FabricSplice::constructExternalArrayRTVal("UInt32", meshData.indices.length(), &meshData.indices[0]);
+    rtMesh.callMethod("", "getTopologyAsCountsIndicesExternalArrays", 2, &args[0]);
   }
 
-  MPointArray  mayaPoints;
-  MVectorArray mayaNormals;
-  MIntArray    mayaCounts;
-  MIntArray    mayaIndices;
+  meshData.hasUVs = rtMesh.callMethod( "Boolean", "hasUVs", 0, 0 ).getBoolean();
+  if( meshData.hasUVs ) {
+    meshData.uvValues.setLength( meshData.nbSamples * 2 );
+    std::vector<FabricCore::RTVal> args( 2 );
+    args[0] = FabricSplice::constructExternalArrayRTVal( "Float32", meshData.uvValues.length(), &meshData.uvValues[0] );
+    args[1] = FabricSplice::constructUInt32RTVal( 2 ); // components
+    rtMesh.callMethod( "", "getUVsAsExternalArray", 2, &args[0] );
+  }
+
+  meshData.hasColors = rtMesh.callMethod( "Boolean", "hasVertexColors", 0, 0 ).getBoolean();
+  if( meshData.hasColors ) {
+    meshData.colors.setLength( meshData.nbSamples );
+    std::vector<FabricCore::RTVal> args( 2 );
+    args[0] = FabricSplice::constructExternalArrayRTVal( "Float32", meshData.colors.length() * 4, &meshData.colors[0] );
+    args[1] = FabricSplice::constructUInt32RTVal( 4 ); // components
+    rtMesh.callMethod( "", "getVertexColorsAsExternalArray", 2, &args[0] );
+  }
+}
+
+// only calls into Maya, the result is stored in meshData.meshObject.
+static void dfgBuildPolygonMeshData(DFGPolygonMeshOutputData & meshData, bool insideCompute)
+{
+  MPointArray  & mayaPoints  = meshData.points;
+  MVectorArray & mayaNormals = meshData.normals;
+  MIntArray    & mayaCounts  = meshData.counts;
+  MIntArray    & mayaIndices = meshData.indices;
+  unsigned int nbPoints   = meshData.nbPoints;
+  unsigned int nbPolygons = meshData.nbPolygons;
+  unsigned int nbSamples  = meshData.nbSamples;
 
   #if MAYA_API_VERSION < 201500         // FE-5118 ("crash when saving scene with an empty polygon mesh")
 
@@ -4790,11 +5543,11 @@ MObject dfgPolygonMeshToMFnMesh(FabricCore::RTVal rtMesh, bool insideCompute)
     {
       MObject meshObject = meshDataFn.create();
       mesh.create( mayaPoints.length(), mayaCounts.length(), mayaPoints, mayaCounts, mayaIndices, meshObject );
-      result = meshObject;
+      meshData.meshObject = meshObject;
     }
     else
     {
-      result = mesh.create( mayaPoints.length(), mayaCounts.length(), mayaPoints, mayaCounts, mayaIndices, MObject::kNullObj );
+      meshData.meshObject = mesh.create( mayaPoints.length(), mayaCounts.length(), mayaPoints, mayaCounts, mayaIndices, MObject::kNullObj );
     }
     mesh.updateSurface();
   }
@@ -4802,33 +5555,6 @@ MObject dfgPolygonMeshToMFnMesh(FabricCore::RTVal rtMesh, bool insideCompute)
 
   #endif
   {
-    mayaPoints.setLength(nbPoints);
-    if(mayaPoints.length() > 0)
-    {
-      std::vector<FabricCore::RTVal> args(2);
-      args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
-      args[1] = FabricSplice::constructUInt32RTVal(4); // components
-      rtMesh.callMethod("", "getPointsAsExternalArray_d", 2, &args[0]);
-    }
-
-    mayaNormals.setLength(nbSamples);
-    if(mayaNormals.length() > 0)
-    {
-      FabricCore::RTVal normalsVar = 
-      FabricSplice::constructExternalArrayRTVal("Float64", mayaNormals.length() * 3, &mayaNormals[0]);
-      rtMesh.callMethod("", "getNormalsAsExternalArray_d", 1, &normalsVar);
-    }
-
-    mayaCounts.setLength(nbPolygons);
-    mayaIndices.setLength(nbSamples);
-    if(mayaCounts.length() > 0 && mayaIndices.length() > 0)
-    {
-      std::vector<FabricCore::RTVal> args(2);
-      args[0] = FabricSplice::constructExternalArrayRTVal("UInt32", mayaCounts.length(),  &mayaCounts[0]);
-      args[1] = FabricSplice::constructExternalArrayRTVal("UInt32", mayaIndices.length(), &mayaIndices[0]);
-      rtMesh.callMethod("", "getTopologyAsCountsIndicesExternalArrays", 2, &args[0]);
-    }
-
     MFnMeshData meshDataFn;
     MFnMesh mesh;
 
@@ -4856,83 +5582,256 @@ MObject dfgPolygonMeshToMFnMesh(FabricCore::RTVal rtMesh, bool insideCompute)
     {
       MObject meshObject = meshDataFn.create();
       mesh.create( mayaPoints.length(), mayaCounts.length(), mayaPoints, mayaCounts, mayaIndices, meshObject );
-      result = meshObject;
+      meshData.meshObject = meshObject;
     }
     else
     {
-      result = mesh.create( mayaPoints.length(), mayaCounts.length(), mayaPoints, mayaCounts, mayaIndices, MObject::kNullObj );
+      meshData.meshObject = mesh.create( mayaPoints.length(), mayaCounts.length(), mayaPoints, mayaCounts, mayaIndices, MObject::kNullObj );
     }
 
     mesh.updateSurface();
     mayaPoints.clear();
     mesh.setFaceVertexNormals( mayaNormals, normalFace, normalVertex );
 
-    if( !rtMesh.isNullObject() ) {
-
-      if( rtMesh.callMethod( "Boolean", "hasUVs", 0, 0 ).getBoolean() ) {
-        MFloatArray values( nbSamples * 2 );
-        std::vector<FabricCore::RTVal> args( 2 );
-        args[0] = FabricSplice::constructExternalArrayRTVal( "Float32", values.length(), &values[0] );
-        args[1] = FabricSplice::constructUInt32RTVal( 2 ); // components
-        rtMesh.callMethod( "", "getUVsAsExternalArray", 2, &args[0] );
-
-        MFloatArray u, v;
-        u.setLength( nbSamples );
-        v.setLength( nbSamples );
-        unsigned int offset = 0;
-        for( unsigned int i = 0; i < u.length(); i++ ) {
-          u[i] = values[offset++];
-          v[i] = values[offset++];
-        }
-        values.clear();
-        MString setName( "map1" );
-        mesh.createUVSet( setName );
-        mesh.setCurrentUVSetName( setName );
+    if( meshData.hasUVs ) {
+      MFloatArray u, v;
+      u.setLength( nbSamples );
+      v.setLength( nbSamples );
+      unsigned int offset = 0;
+      for( unsigned int i = 0; i < u.length(); i++ ) {
+        u[i] = meshData.uvValues[offset++];
+        v[i] = meshData.uvValues[offset++];
+      }
+      meshData.uvValues.clear();
+      MString setName( "map1" );
+      mesh.createUVSet( setName );
+      mesh.setCurrentUVSetName( setName );
+
+      mesh.setUVs( u, v );
+
+      MIntArray indices( nbSamples );
+      for( unsigned int i = 0; i < nbSamples; i++ )
+        indices[i] = i;
+      mesh.assignUVs( mayaCounts, indices );
+    }
+
+    if( meshData.hasColors ) {
+      MString setName( "colorSet" );
+      mesh.createColorSet( setName );
+      mesh.setCurrentColorSetName( setName );
 
-        mesh.setUVs( u, v );
+      MIntArray face( nbSamples );
 
-        MIntArray indices( nbSamples );
-        for( unsigned int i = 0; i < nbSamples; i++ )
-          indices[i] = i;
-        mesh.assignUVs( mayaCounts, indices );
+      unsigned int offset = 0;
+      for( unsigned int i = 0; i < mayaCounts.length(); i++ ) {
+        for( int j = 0; j < mayaCounts[i]; j++, offset++ ) {
+          face[offset] = i;
+        }
       }
 
-      if( rtMesh.callMethod( "Boolean", "hasVertexColors", 0, 0 ).getBoolean() ) {
-        MColorArray values( nbSamples );
-        std::vector<FabricCore::RTVal> args( 2 );
-        args[0] = FabricSplice::constructExternalArrayRTVal( "Float32", values.length() * 4, &values[0] );
-        args[1] = FabricSplice::constructUInt32RTVal( 4 ); // components
-        rtMesh.callMethod( "", "getVertexColorsAsExternalArray", 2, &args[0] );
+      mesh.setFaceVertexColors( meshData.colors, face, mayaIndices );
+    }
+  }
+}
+
+MObject dfgPolygonMeshToMFnMesh(FabricCore::RTVal rtMesh, bool insideCompute)
+{
+  DFGPolygonMeshOutputData meshData;
+  CORE_CATCH_BEGIN;
+  dfgFetchPolygonMeshData(rtMesh, meshData);
+  dfgBuildPolygonMeshData(meshData, insideCompute);
+  CORE_CATCH_END;
 
-        MString setName( "colorSet" );
-        mesh.createColorSet( setName );
-        mesh.setCurrentColorSetName( setName );
+  return meshData.meshObject;
+}
 
-        MIntArray face( nbSamples );
+static void dfgBuildPolygonMeshesTask(void * userData, unsigned int index)
+{
+  std::vector<DFGPolygonMeshOutputData *> * meshData = (std::vector<DFGPolygonMeshOutputData *> *)userData;
+  dfgBuildPolygonMeshData(*(*meshData)[index], true);
+}
 
-        unsigned int offset = 0;
-        for( unsigned int i = 0; i < mayaCounts.length(); i++ ) {
-          for( int j = 0; j < mayaCounts[i]; j++, offset++ ) {
-            face[offset] = i;
-          }
-        }
+// fingerprints the fetched mesh data, before dfgBuildPolygonMeshData consumes it
+static void dfgHashPolygonMeshOutputData(const DFGPolygonMeshOutputData & meshData, DFGPolygonMeshOutputCache & cache)
+{
+  cache.nbPoints = meshData.nbPoints;
+  cache.nbPolygons = meshData.nbPolygons;
+  cache.nbSamples = meshData.nbSamples;
+  cache.hasUVs = meshData.hasUVs;
+  cache.hasColors = meshData.hasColors;
+
+  cache.topologyHash = DFG_HASH_SEED;
+  if(meshData.counts.length() > 0)
+    cache.topologyHash = dfgHashBuffer(&meshData.counts[0], sizeof(int) * meshData.counts.length(), cache.topologyHash);
+  if(meshData.indices.length() > 0)
+    cache.topologyHash = dfgHashBuffer(&meshData.indices[0], sizeof(int) * meshData.indices.length(), cache.topologyHash);
+
+  cache.pointsHash = DFG_HASH_SEED;
+  if(meshData.points.length() > 0)
+    cache.pointsHash = dfgHashBuffer(&meshData.points[0], sizeof(MPoint) * meshData.points.length(), cache.pointsHash);
+
+  cache.normalsHash = DFG_HASH_SEED;
+  if(meshData.normals.length() > 0)
+    cache.normalsHash = dfgHashBuffer(&meshData.normals[0], sizeof(MVector) * meshData.normals.length(), cache.normalsHash);
+
+  cache.uvsHash = DFG_HASH_SEED;
+  if(meshData.hasUVs && meshData.uvValues.length() > 0)
+    cache.uvsHash = dfgHashBuffer(&meshData.uvValues[0], sizeof(float) * meshData.uvValues.length(), cache.uvsHash);
+
+  cache.colorsHash = DFG_HASH_SEED;
+  if(meshData.hasColors && meshData.colors.length() > 0)
+    cache.colorsHash = dfgHashBuffer(&meshData.colors[0], sizeof(MColor) * meshData.colors.length(), cache.colorsHash);
+}
+
+// updates meshObject in place from the fetched data if it's the mesh described
+// by cache and the topology is unchanged. the components are only written if
+// their fingerprint differs from the one of the previous write, so nothing is
+// read back from Maya. written holds the fingerprints of meshData. the points
+// are always written, unless skipUnchangedPoints is set: then a mesh whose
+// fingerprints all match isn't written at all.
+static bool dfgUpdatePolygonMeshData(
+  DFGPolygonMeshOutputData & meshData,
+  const DFGPolygonMeshOutputCache & written,
+  MObject meshObject,
+  const DFGPolygonMeshOutputCache & cache,
+  bool skipUnchangedPoints
+  )
+{
+  if(!cache.valid || meshObject.isNull() || !(cache.meshObject == MObjectHandle(meshObject)))
+    return false;
+
+  if(written.nbPoints == 0 || written.nbPolygons == 0)
+    return false;
+
+  if(written.nbPoints     != cache.nbPoints ||
+     written.nbPolygons   != cache.nbPolygons ||
+     written.nbSamples    != cache.nbSamples ||
+     written.hasUVs       != cache.hasUVs ||
+     written.hasColors    != cache.hasColors ||
+     written.topologyHash != cache.topologyHash)
+    return false;
+
+  MStatus status;
+  MFnMesh mesh(meshObject, &status);
+  if(status != MS::kSuccess)
+    return false;
+
+  // cheap guard against the mesh having been replaced by another one
+  if(written.nbPoints   != (unsigned int)mesh.numVertices() ||
+     written.nbPolygons != (unsigned int)mesh.numPolygons() ||
+     written.nbSamples  != (unsigned int)mesh.numFaceVertices())
+    return false;
+
+  unsigned int nbPolygons = written.nbPolygons;
+  unsigned int nbSamples = written.nbSamples;
+
+  if(!skipUnchangedPoints || written.pointsHash != cache.pointsHash)
+    mesh.setPoints(meshData.points);
+
+  if(written.normalsHash != cache.normalsHash)
+  {
+    MIntArray normalFace(nbSamples), normalVertex(nbSamples);
+    unsigned int offset = 0;
+    for( unsigned int i = 0; i < nbPolygons; i++ ) {
+      for( int j = 0; j < meshData.counts[i]; j++, offset++ ) {
+        normalFace[offset] = i;
+        normalVertex[offset] = meshData.indices[offset];
+      }
+    }
+    mesh.setFaceVertexNormals( meshData.normals, normalFace, normalVertex );
+  }
+
+  if( written.hasUVs && written.uvsHash != cache.uvsHash ) {
+    MString uvSetName( "map1" );
+    MFloatArray u( nbSamples ), v( nbSamples );
+    unsigned int offset = 0;
+    for( unsigned int i = 0; i < nbSamples; i++ ) {
+      u[i] = meshData.uvValues[offset++];
+      v[i] = meshData.uvValues[offset++];
+    }
+    mesh.setUVs( u, v, &uvSetName );
+  }
 
-        mesh.setFaceVertexColors( values, face, mayaIndices );
+  if( written.hasColors && written.colorsHash != cache.colorsHash ) {
+    MString colorSetName( "colorSet" );
+    MIntArray face( nbSamples );
+    unsigned int offset = 0;
+    for( unsigned int i = 0; i < nbPolygons; i++ ) {
+      for( int j = 0; j < meshData.counts[i]; j++, offset++ ) {
+        face[offset] = i;
       }
     }
 
+    mesh.setCurrentColorSetName( colorSetName );
+    mesh.setFaceVertexColors( meshData.colors, face, meshData.indices );
+  }
+
+  return true;
+}
+
+bool dfgPolygonMeshUpdateMFnMesh(FabricCore::RTVal rtMesh, MObject meshObject, DFGPolygonMeshOutputCache & cache)
+{
+  FabricMayaProfilingEvent bracket("dfgPolygonMeshUpdateMFnMesh");
+
+  bool updated = false;
+  CORE_CATCH_BEGIN;
+
+  if(!cache.valid || meshObject.isNull() || !rtMesh.isValid() || rtMesh.isNullObject())
+    return false;
+
+  DFGPolygonMeshOutputData meshData;
+  dfgFetchPolygonMeshData(rtMesh, meshData);
+
+  DFGPolygonMeshOutputCache written;
+  dfgHashPolygonMeshOutputData(meshData, written);
+  if(dfgUpdatePolygonMeshData(meshData, written, meshObject, cache, false))
+  {
+    written.valid = true;
+    written.meshObject = cache.meshObject;
+    cache = written;
+    updated = true;
   }
 
   CORE_CATCH_END;
 
-  return result;
+  return updated;
+}
+
+// writes the fetched mesh to the handle, in place if possible. the meshes
+// which need to be rebuilt are returned as false, the caller builds them
+// and stores them with dfgPortToPlug_PolygonMesh_setMesh.
+static bool dfgPortToPlug_PolygonMesh_updateMesh(
+  MDataHandle handle,
+  DFGPolygonMeshOutputData & meshData,
+  DFGPolygonMeshOutputCache & written,
+  const DFGPolygonMeshOutputCache & cache,
+  bool skipUnchangedPoints
+  )
+{
+  if(handle.type() != MFnData::kMesh)
+    return false;
+
+  MObject currentMeshObject = handle.asMesh();
+  if(!dfgUpdatePolygonMeshData(meshData, written, currentMeshObject, cache, skipUnchangedPoints))
+    return false;
+
+  handle.set( currentMeshObject );
+  handle.setClean();
+  written.valid = true;
+  written.meshObject = cache.meshObject;
+  return true;
 }
 
-void dfgPortToPlug_PolygonMesh_singleMesh(MDataHandle handle, FabricCore::RTVal rtMesh)
+static void dfgPortToPlug_PolygonMesh_setMesh(
+  MDataHandle handle,
+  DFGPolygonMeshOutputData & meshData,
+  DFGPolygonMeshOutputCache & written
+  )
 {
-  MObject meshObject = dfgPolygonMeshToMFnMesh(rtMesh, true);
-  handle.set( meshObject );
+  handle.set( meshData.meshObject );
   handle.setClean();
+  written.valid = !meshData.meshObject.isNull();
+  written.meshObject = MObjectHandle(meshData.meshObject);
 }
 
 void dfgPortToPlug_PolygonMesh(
@@ -4947,6 +5846,13 @@ void dfgPortToPlug_PolygonMesh(
   MPlug &plug, 
   MDataBlock &data)
 {
+  // an Out port's mesh which didn't change at all since the last compute
+  // isn't written again. IO ports can be set from Maya, so their points
+  // are always written. evaluations in other contexts than the normal one
+  // don't use the caches, as they don't share the data block values.
+  bool useCache = data.context().isNormal();
+  bool skipUnchangedPoints = argOutsidePortType == FabricCore::DFGPortType_Out;
+
   try
   {
     FabricCore::RTVal rtVal(getCB(getSetUD));
@@ -4955,9 +5861,43 @@ void dfgPortToPlug_PolygonMesh(
       MArrayDataHandle arrayHandle = data.outputArrayValue(plug);
       MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
+      // the meshes are fetched from KL in order. the ones which can't be
+      // updated in place are then built concurrently and set on the plug.
       unsigned int elements = rtVal.getArraySize();
+      std::vector<DFGPolygonMeshOutputData> meshData(elements);
+      std::vector<DFGPolygonMeshOutputCache> written(elements);
+      std::vector<DFGPolygonMeshOutputData *> meshesToBuild;
+      std::vector<unsigned int> meshesToBuildIndices;
       for(unsigned int i = 0; i < elements; ++i)
-        dfgPortToPlug_PolygonMesh_singleMesh(arraybuilder.addElement(i), rtVal.getArrayElement(i));
+      {
+        CORE_CATCH_BEGIN;
+        dfgFetchPolygonMeshData(rtVal.getArrayElement(i), meshData[i]);
+        CORE_CATCH_END;
+        dfgHashPolygonMeshOutputData(meshData[i], written[i]);
+
+        DFGPolygonMeshOutputCache cache;
+        if(useCache)
+          cache = dfgGetGeometryCache(&DFGGeometryNodeCache::outputs, plug, (int)i);
+        if(dfgPortToPlug_PolygonMesh_updateMesh(arraybuilder.addElement(i), meshData[i], written[i], cache, skipUnchangedPoints))
+        {
+          if(useCache)
+            dfgSetGeometryCache(&DFGGeometryNodeCache::outputs, plug, (int)i, written[i]);
+          continue;
+        }
+
+        meshesToBuild.push_back(&meshData[i]);
+        meshesToBuildIndices.push_back(i);
+      }
+
+      dfgParallelFor((unsigned int)meshesToBuild.size(), dfgBuildPolygonMeshesTask, &meshesToBuild);
+
+      for(size_t i = 0; i < meshesToBuildIndices.size(); ++i)
+      {
+        unsigned int index = meshesToBuildIndices[i];
+        dfgPortToPlug_PolygonMesh_setMesh(arraybuilder.addElement(index), meshData[index], written[index]);
+        if(useCache)
+          dfgSetGeometryCache(&DFGGeometryNodeCache::outputs, plug, (int)index, written[index]);
+      }
 
       arrayHandle.set(arraybuilder);
       arrayHandle.setAllClean();
@@ -4965,7 +5905,24 @@ void dfgPortToPlug_PolygonMesh(
     else
     {
       MDataHandle handle = data.outputValue(plug.attribute());
-      dfgPortToPlug_PolygonMesh_singleMesh(handle, rtVal);
+
+      DFGPolygonMeshOutputData meshData;
+      DFGPolygonMeshOutputCache written;
+      CORE_CATCH_BEGIN;
+      dfgFetchPolygonMeshData(rtVal, meshData);
+      CORE_CATCH_END;
+      dfgHashPolygonMeshOutputData(meshData, written);
+
+      DFGPolygonMeshOutputCache cache;
+      if(useCache)
+        cache = dfgGetGeometryCache(&DFGGeometryNodeCache::outputs, plug, -1);
+      if(!dfgPortToPlug_PolygonMesh_updateMesh(handle, meshData, written, cache, skipUnchangedPoints))
+      {
+        dfgBuildPolygonMeshData(meshData, true);
+        dfgPortToPlug_PolygonMesh_setMesh(handle, meshData, written);
+      }
+      if(useCache)
+        dfgSetGeometryCache(&DFGGeometryNodeCache::outputs, plug, -1, written);
     }
   }
   catch(FabricCore::Exception e)
@@ -4980,34 +5937,52 @@ void dfgPortToPlug_PolygonMesh(
   }
 }
 
-void dfgPortToPlug_Lines_singleLines(MDataHandle handle, FabricCore::RTVal rtVal)
+struct DFGLinesOutputData
 {
-  CORE_CATCH_BEGIN;
+  unsigned int nbPoints;
+  std::vector<double> positions;
+  std::vector<uint32_t> indices;
+  MObject curveObject;
 
-  unsigned int nbPoints = 0;
+  DFGLinesOutputData()
+  : nbPoints(0)
+  {}
+};
+
+static void dfgFetchLinesData(FabricCore::RTVal rtVal, DFGLinesOutputData & linesData)
+{
   unsigned int nbSegments = 0;
   if(!rtVal.isNullObject())
   {
-    nbPoints   = rtVal.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
-    nbSegments = rtVal.callMethod("UInt64", "lineCount",  0, 0).getUInt64();
+    linesData.nbPoints = rtVal.callMethod("UInt64", "pointCount", 0, 0).getUInt64();
+    nbSegments         = rtVal.callMethod("UInt64", "lineCount",  0, 0).getUInt64();
   }
 
-  MPointArray mayaPoints(nbPoints);
-  std::vector<double> mayaDoubles(nbPoints * 3);
-  std::vector<uint32_t> mayaIndices(nbSegments*2);
-  MDoubleArray mayaKnots(nbPoints);
+  linesData.positions.resize(linesData.nbPoints * 3);
+  linesData.indices.resize(nbSegments * 2);
 
-  if(nbPoints > 0)
+  if(linesData.nbPoints > 0)
   {
-    FabricCore::RTVal mayaDoublesVal = FabricSplice::constructExternalArrayRTVal("Float64", mayaDoubles.size(), &mayaDoubles[0]);
+    FabricCore::RTVal mayaDoublesVal = FabricSplice::constructExternalArrayRTVal("Float64", linesData.positions.size(), &linesData.positions[0]);
     rtVal.callMethod("", "_getPositionsAsExternalArray_d", 1, &mayaDoublesVal);
   }
 
   if(nbSegments > 0)
   {
-    FabricCore::RTVal mayaIndicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", mayaIndices.size(), &mayaIndices[0]);
+    FabricCore::RTVal mayaIndicesVal = FabricSplice::constructExternalArrayRTVal("UInt32", linesData.indices.size(), &linesData.indices[0]);
     rtVal.callMethod("", "_getTopologyAsExternalArray", 1, &mayaIndicesVal);
   }
+}
+
+// only calls into Maya, the result is stored in linesData.curveObject.
+static void dfgBuildLinesData(DFGLinesOutputData & linesData)
+{
+  unsigned int nbPoints = linesData.nbPoints;
+  std::vector<double> & mayaDoubles = linesData.positions;
+  std::vector<uint32_t> & mayaIndices = linesData.indices;
+
+  MPointArray mayaPoints(nbPoints);
+  MDoubleArray mayaKnots(nbPoints);
 
   size_t offset = 0;
   for(unsigned int i=0;i<nbPoints;i++) {
@@ -5037,8 +6012,69 @@ void dfgPortToPlug_Lines_singleLines(MDataHandle handle, FabricCore::RTVal rtVal
     false,
     curveObject);
 
-  handle.set(curveObject);
+  linesData.curveObject = curveObject;
+}
+
+static void dfgBuildLinesTask(void * userData, unsigned int index)
+{
+  std::vector<DFGLinesOutputData *> * linesData = (std::vector<DFGLinesOutputData *> *)userData;
+  dfgBuildLinesData(*(*linesData)[index]);
+}
+
+static uint64_t dfgHashLinesOutputData(const DFGLinesOutputData & linesData)
+{
+  uint64_t hash = dfgHashBuffer(&linesData.nbPoints, sizeof(linesData.nbPoints));
+  if(linesData.positions.size() > 0)
+    hash = dfgHashBuffer(&linesData.positions[0], sizeof(double) * linesData.positions.size(), hash);
+  if(linesData.indices.size() > 0)
+    hash = dfgHashBuffer(&linesData.indices[0], sizeof(uint32_t) * linesData.indices.size(), hash);
+  return hash;
+}
+
+// returns true if the handle still holds the curve written to it last time
+// and the fetched data hashes the same, so the curve doesn't need a rebuild.
+static bool dfgCurveOutputUnchanged(MDataHandle handle, MPlug & plug, int elementIndex, uint64_t hash)
+{
+  DFGCurveOutputCache cache = dfgGetGeometryCache(&DFGGeometryNodeCache::curveOutputs, plug, elementIndex);
+  if(!cache.valid || cache.hash != hash)
+    return false;
+  MObject currentCurveObject = handle.data();
+  return !currentCurveObject.isNull() && cache.curveObject == currentCurveObject;
+}
+
+static void dfgSetCurveOutputCache(MPlug & plug, int elementIndex, MObject curveObject, uint64_t hash)
+{
+  DFGCurveOutputCache cache;
+  cache.valid = !curveObject.isNull();
+  cache.curveObject = MObjectHandle(curveObject);
+  cache.hash = hash;
+  dfgSetGeometryCache(&DFGGeometryNodeCache::curveOutputs, plug, elementIndex, cache);
+}
+
+void dfgPortToPlug_Lines_singleLines(MDataHandle handle, FabricCore::RTVal rtVal, MPlug & plug, bool useCache)
+{
+  CORE_CATCH_BEGIN;
+
+  DFGLinesOutputData linesData;
+  dfgFetchLinesData(rtVal, linesData);
+
+  uint64_t hash = 0;
+  if(useCache)
+  {
+    hash = dfgHashLinesOutputData(linesData);
+    if(dfgCurveOutputUnchanged(handle, plug, -1, hash))
+    {
+      handle.setClean();
+      return;
+    }
+  }
+
+  dfgBuildLinesData(linesData);
+
+  handle.set(linesData.curveObject);
   handle.setClean();
+  if(useCache)
+    dfgSetCurveOutputCache(plug, -1, linesData.curveObject, hash);
 
   CORE_CATCH_END;
 }
@@ -5054,6 +6090,11 @@ void dfgPortToPlug_Lines(
   void *getSetUD,
   MPlug &plug, MDataBlock &data)
 {
+  // the curves of an Out port whose lines didn't change since the last
+  // compute are kept. IO ports can be set from Maya, so they're always
+  // rebuilt, as are the evaluations in other contexts than the normal one.
+  bool useCache = argOutsidePortType == FabricCore::DFGPortType_Out && data.context().isNormal();
+
   try
   {
     FabricCore::RTVal rtVal(getCB(getSetUD));
@@ -5062,9 +6103,44 @@ void dfgPortToPlug_Lines(
       MArrayDataHandle arrayHandle = data.outputArrayValue(plug);
       MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
+      // fetch the lines from KL in order, build the changed curves concurrently
       unsigned int elements = rtVal.getArraySize();
+      std::vector<DFGLinesOutputData> linesData(elements);
+      std::vector<uint64_t> hashes(elements, 0);
+      std::vector<DFGLinesOutputData *> linesToBuild;
+      std::vector<unsigned int> linesToBuildIndices;
       for(unsigned int i = 0; i < elements; ++i)
-        dfgPortToPlug_Lines_singleLines(arraybuilder.addElement(i), rtVal.getArrayElement(i));
+      {
+        CORE_CATCH_BEGIN;
+        dfgFetchLinesData(rtVal.getArrayElement(i), linesData[i]);
+        CORE_CATCH_END;
+
+        if(useCache)
+        {
+          hashes[i] = dfgHashLinesOutputData(linesData[i]);
+          MDataHandle handle = arraybuilder.addElement(i);
+          if(dfgCurveOutputUnchanged(handle, plug, (int)i, hashes[i]))
+          {
+            handle.setClean();
+            continue;
+          }
+        }
+
+        linesToBuild.push_back(&linesData[i]);
+        linesToBuildIndices.push_back(i);
+      }
+
+      dfgParallelFor((unsigned int)linesToBuild.size(), dfgBuildLinesTask, &linesToBuild);
+
+      for(size_t i = 0; i < linesToBuildIndices.size(); ++i)
+      {
+        unsigned int index = linesToBuildIndices[i];
+        MDataHandle handle = arraybuilder.addElement(index);
+        handle.set(linesData[index].curveObject);
+        handle.setClean();
+        if(useCache)
+          dfgSetCurveOutputCache(plug, (int)index, linesData[index].curveObject, hashes[index]);
+      }
 
       arrayHandle.set(arraybuilder);
       arrayHandle.setAllClean();
@@ -5072,7 +6148,7 @@ void dfgPortToPlug_Lines(
     else
     {
       MDataHandle handle = data.outputValue(plug.attribute());
-      dfgPortToPlug_Lines_singleLines(handle, rtVal);
+      dfgPortToPlug_Lines_singleLines(handle, rtVal, plug, useCache);
     }
   }
   catch(FabricCore::Exception e)
@@ -5087,14 +6163,25 @@ void dfgPortToPlug_Lines(
   }
 }
 
-void dfgPortToPlug_Curves_single( MDataHandle handle, FabricCore::RTVal rtVal, int index ) {
-  CORE_CATCH_BEGIN;
+struct DFGCurveOutputData
+{
+  MFnNurbsCurve::Form form;
+  unsigned int degree;
+  bool isRational;
+  MPointArray points;
+  MDoubleArray knots;
+  MObject curveObject;
 
-  MFnNurbsCurve::Form form = MFnNurbsCurve::kOpen;
+  DFGCurveOutputData()
+  : form(MFnNurbsCurve::kOpen)
+  , degree(1)
+  , isRational(false)
+  {}
+};
+
+static void dfgFetchCurveData( FabricCore::RTVal rtVal, int index, DFGCurveOutputData & curveData ) {
   unsigned int nbPoints = 0;
   unsigned int nbKnots = 0;
-  unsigned int degree = 1;
-  bool isRational = false;
 
   FabricCore::RTVal args[6];
   args[0] = FabricSplice::constructUInt32RTVal( index );//curveIndex
@@ -5108,44 +6195,87 @@ void dfgPortToPlug_Curves_single( MDataHandle handle, FabricCore::RTVal rtVal, i
 
     rtVal.callMethod( "", "getCurveInfoForMaya", 6, args );
 
-    degree = args[1].getUInt8();
+    curveData.degree = args[1].getUInt8();
 
     int fabricForm = args[2].getUInt8();
     if( fabricForm == 1 )
-      form = MFnNurbsCurve::kClosed;
+      curveData.form = MFnNurbsCurve::kClosed;
     else if( fabricForm == 2 )
-      form = MFnNurbsCurve::kPeriodic;
+      curveData.form = MFnNurbsCurve::kPeriodic;
 
-    isRational = args[3].getBoolean();
+    curveData.isRational = args[3].getBoolean();
 
     nbKnots = args[4].getUInt32();
     nbPoints = args[5].getUInt32();
   }
 
-  MPointArray mayaPoints( nbPoints );
-  MDoubleArray mayaKnots( nbKnots );
+  curveData.points.setLength( nbPoints );
+  curveData.knots.setLength( nbKnots );
 
   if( nbPoints > 0 ) {
-    args[1] = FabricSplice::constructExternalArrayRTVal( "Float64", mayaPoints.length() * 4, &mayaPoints[0] );//points
-    args[2] = FabricSplice::constructExternalArrayRTVal( "Float64", mayaKnots.length(), &mayaKnots[0] );//knots
+    args[1] = FabricSplice::constructExternalArrayRTVal( "Float64", curveData.points.length() * 4, &curveData.points[0] );//points
+    args[2] = FabricSplice::constructExternalArrayRTVal( "Float64", curveData.knots.length(), &curveData.knots[0] );//knots
 
     rtVal.callMethod( "", "getCurveDataForMaya", 3, args );
   }
+}
 
+// only calls into Maya, the result is stored in curveData.curveObject.
+static void dfgBuildCurveData( DFGCurveOutputData & curveData ) {
   MFnNurbsCurveData curveDataFn;
   MObject curveObject;
   MFnNurbsCurve curve;
   curveObject = curveDataFn.create();
 
   curve.create(
-    mayaPoints, mayaKnots, degree,
-    form,
+    curveData.points, curveData.knots, curveData.degree,
+    curveData.form,
     false,
-    isRational,
+    curveData.isRational,
     curveObject );
 
-  handle.set( curveObject );
+  curveData.curveObject = curveObject;
+}
+
+static void dfgBuildCurvesTask( void * userData, unsigned int index ) {
+  std::vector<DFGCurveOutputData *> * curveData = (std::vector<DFGCurveOutputData *> *)userData;
+  dfgBuildCurveData( *(*curveData)[index] );
+}
+
+static uint64_t dfgHashCurveOutputData( const DFGCurveOutputData & curveData ) {
+  uint64_t hash = dfgHashBuffer( &curveData.form, sizeof( curveData.form ) );
+  hash = dfgHashBuffer( &curveData.degree, sizeof( curveData.degree ), hash );
+  hash = dfgHashBuffer( &curveData.isRational, sizeof( curveData.isRational ), hash );
+  unsigned int nbPoints = curveData.points.length();
+  hash = dfgHashBuffer( &nbPoints, sizeof( nbPoints ), hash );
+  if( nbPoints > 0 )
+    hash = dfgHashBuffer( &curveData.points[0], sizeof( MPoint ) * nbPoints, hash );
+  if( curveData.knots.length() > 0 )
+    hash = dfgHashBuffer( &curveData.knots[0], sizeof( double ) * curveData.knots.length(), hash );
+  return hash;
+}
+
+void dfgPortToPlug_Curves_single( MDataHandle handle, FabricCore::RTVal rtVal, int index, MPlug & plug, bool useCache ) {
+  CORE_CATCH_BEGIN;
+
+  DFGCurveOutputData curveData;
+  dfgFetchCurveData( rtVal, index, curveData );
+
+  uint64_t hash = 0;
+  if( useCache ) {
+    hash = dfgHashCurveOutputData( curveData );
+    if( dfgCurveOutputUnchanged( handle, plug, -1, hash ) ) {
+      handle.setClean();
+      return;
+    }
+  }
+
+  dfgBuildCurveData( curveData );
+
+  handle.set( curveData.curveObject );
   handle.setClean();
+  if( useCache )
+    dfgSetCurveOutputCache( plug, -1, curveData.curveObject, hash );
 
   CORE_CATCH_END;
 }
@@ -5161,20 +6291,54 @@ void dfgPortToPlug_Curves(
   void *getSetUD,
   MPlug &plug, MDataBlock &data ) {
 
+  // same as for the Lines, unchanged curves of Out ports are kept
+  bool useCache = argOutsidePortType == FabricCore::DFGPortType_Out && data.context().isNormal();
+
   FabricCore::RTVal rtVal( getCB( getSetUD ) );
   if( plug.isArray() ) {
     MArrayDataHandle arrayHandle = data.outputArrayValue( plug );
     MArrayDataBuilder arraybuilder = arrayHandle.builder();
 
+    // fetch the curves from KL in order, build the changed ones concurrently
     unsigned int elements = rtVal.isNullObject() ? 0 : rtVal.callMethod( "UInt32", "curveCount", 0, 0 ).getUInt32();
-    for( unsigned int i = 0; i < elements; ++i )
-      dfgPortToPlug_Curves_single( arraybuilder.addElement( i ), rtVal, i );
+    std::vector<DFGCurveOutputData> curveData( elements );
+    std::vector<uint64_t> hashes( elements, 0 );
+    std::vector<DFGCurveOutputData *> curvesToBuild;
+    std::vector<unsigned int> curvesToBuildIndices;
+    for( unsigned int i = 0; i < elements; ++i ) {
+      CORE_CATCH_BEGIN;
+      dfgFetchCurveData( rtVal, i, curveData[i] );
+      CORE_CATCH_END;
+
+      if( useCache ) {
+        hashes[i] = dfgHashCurveOutputData( curveData[i] );
+        MDataHandle handle = arraybuilder.addElement( i );
+        if( dfgCurveOutputUnchanged( handle, plug, (int)i, hashes[i] ) ) {
+          handle.setClean();
+          continue;
+        }
+      }
+
+      curvesToBuild.push_back( &curveData[i] );
+      curvesToBuildIndices.push_back( i );
+    }
+
+    dfgParallelFor( (unsigned int)curvesToBuild.size(), dfgBuildCurvesTask, &curvesToBuild );
+
+    for( size_t i = 0; i < curvesToBuildIndices.size(); ++i ) {
+      unsigned int index = curvesToBuildIndices[i];
+      MDataHandle handle = arraybuilder.addElement( index );
+      handle.set( curveData[index].curveObject );
+      handle.setClean();
+      if( useCache )
+        dfgSetCurveOutputCache( plug, (int)index, curveData[index].curveObject, hashes[index] );
+    }
 
     arrayHandle.set( arraybuilder );
     arrayHandle.setAllClean();
   } else {
     MDataHandle handle = data.outputValue( plug.attribute() );
-    dfgPortToPlug_Curves_single( handle, rtVal, 0 );
+    dfgPortToPlug_Curves_single( handle, rtVal, 0, plug, useCache );
   }
 }
 
@@ -5193,8 +6357,10 @@ void dfgPortToPlug_Curve(
   FabricCore::RTVal curvesRTVal = rtVal.callMethod( "Curves", "createCurvesContainerIfNone", 0, 0 );
   unsigned int curveIndex = rtVal.callMethod( "UInt32", "getCurveIndex", 0, 0 ).getUInt32();
 
+  bool useCache = argOutsidePortType == FabricCore::DFGPortType_Out && data.context().isNormal();
+
   MDataHandle handle = data.outputValue( plug.attribute() );
-  dfgPortToPlug_Curves_single( handle, curvesRTVal, curveIndex );
+  dfgPortToPlug_Curves_single( handle, curvesRTVal, curveIndex, plug, useCache );
 }
 
 void dfgPortToPlug_spliceMayaData(
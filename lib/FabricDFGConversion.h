@@ -16,6 +16,10 @@
 #include <maya/MDataHandle.h>
 #include <maya/MFnMesh.h>
 #include <maya/MFnNurbsCurve.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPointArray.h>
+#include <maya/MFloatPointArray.h>
+#include <maya/MItGeometry.h>
 
 #include <FabricCore.h>
 #include <FabricSplice.h>
@@ -53,8 +57,88 @@ typedef void(*DFGArgToPlugFunc)(
 DFGPlugToArgFunc getDFGPlugToArgFunc(const FTL::StrRef &dataType);
 DFGArgToPlugFunc getDFGArgToPlugFunc(const FTL::StrRef &dataType);
 
+// runs func for each index in [0, count) on Maya's thread pool,
+// or serially if there is only one index or no thread pool.
+typedef void(*DFGParallelForFunc)(void * userData, unsigned int index);
+void dfgParallelFor(unsigned int count, DFGParallelForFunc func, void * userData);
+
+#define DFG_HASH_SEED 14695981039346656037ULL
+
+// fingerprints of the mesh last converted into a given port. the topology
+// hash covers the face counts and indices, the other ones the per component
+// values, so that only the changed components need to be uploaded.
+struct DFGPolygonMeshCache
+{
+  bool valid;
+  uint64_t topologyHash;
+  uint64_t normalsHash;
+  uint64_t uvsHash;
+  uint64_t colorsHash;
+
+  DFGPolygonMeshCache()
+  : valid(false)
+  , topologyHash(0)
+  , normalsHash(0)
+  , uvsHash(0)
+  , colorsHash(0)
+  {}
+};
+
+// fingerprints of the mesh last written to an output plug, so that the next
+// compute can update that mesh in place without reading it back from Maya.
+struct DFGPolygonMeshOutputCache
+{
+  bool valid;
+  MObjectHandle meshObject;
+  unsigned int nbPoints;
+  unsigned int nbPolygons;
+  unsigned int nbSamples;
+  bool hasUVs;
+  bool hasColors;
+  uint64_t topologyHash;
+  uint64_t pointsHash;
+  uint64_t normalsHash;
+  uint64_t uvsHash;
+  uint64_t colorsHash;
+
+  DFGPolygonMeshOutputCache()
+  : valid(false)
+  , nbPoints(0)
+  , nbPolygons(0)
+  , nbSamples(0)
+  , hasUVs(false)
+  , hasColors(false)
+  , topologyHash(0)
+  , pointsHash(0)
+  , normalsHash(0)
+  , uvsHash(0)
+  , colorsHash(0)
+  {}
+};
+
+// FNV-1a hash of a raw buffer, chained through the hash argument
+uint64_t dfgHashBuffer(const void * data, size_t size, uint64_t hash = DFG_HASH_SEED);
+// drops the cached geometry fingerprints of the given node
+void dfgClearPolygonMeshCache(MObject node);
+// drops the cached KeyframeTrack of the given anim curve
+void dfgPlugToPort_KeyframeTrack_invalidate(MObject curveObj);
+
 // make low level conversion available since it can be useful for other code paths
-FabricCore::RTVal dfgMFnMeshToPolygonMesh(MFnMesh & mesh, FabricCore::RTVal rtMesh);
+FabricCore::RTVal dfgMFnMeshToPolygonMesh(MFnMesh & mesh, FabricCore::RTVal rtMesh, DFGPolygonMeshCache * cache = NULL);
 bool dfgMFnNurbsCurveToCurves(unsigned int index, MFnNurbsCurve & curve, FabricCore::RTVal & rtCurves);
 MObject dfgPolygonMeshToMFnMesh(FabricCore::RTVal rtMesh, bool insideCompute = true);
+// updates meshObject in place if it is the mesh described by the cache and its
+// topology matches the one of rtMesh, only writing the changed components.
+// returns false if the mesh needs to be rebuilt with dfgPolygonMeshToMFnMesh.
+bool dfgPolygonMeshUpdateMFnMesh(FabricCore::RTVal rtMesh, MObject meshObject, DFGPolygonMeshOutputCache & cache);
+// the points of a PolygonMesh from and to the deformers. the MPointArray
+// variants go through Float64 x4, the float32 ones take the raw points of a
+// mesh (MFnMesh::getRawPoints) and fill the MFloatPointArray's buffer.
+bool dfgSetPolygonMeshPoints(FabricCore::RTVal & rtMesh, MPointArray & mayaPoints);
+bool dfgGetPolygonMeshPoints(FabricCore::RTVal & rtMesh, MPointArray & mayaPoints);
+bool dfgSetPolygonMeshPoints(FabricCore::RTVal & rtMesh, const float * mayaPoints, unsigned int nbPoints);
+bool dfgGetPolygonMeshPoints(FabricCore::RTVal & rtMesh, MFloatPointArray & mayaPoints);
+// returns the mesh held by a geometry handle if the iterator covers
+// all of its points in order, so that the float32 path can be used.
+bool dfgGetFullMesh(MDataHandle & geomHandle, MItGeometry & iter, MObject & meshObj);
 // todo: MObject dfgCurvesMeshToMfnNurbsCurve(FabricCore::RTVal rtCurves, bool insideCompute = true);
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2010-2017 Fabric Software Inc. All rights reserved.
+//
+
+#include "FabricDFGConversionKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define FABRIC_DFG_CONVERSION_SSE2
+# include <emmintrin.h>
+#endif
+
+void dfgNarrowFloat64ToFloat32(const double * src, float * dst, size_t count)
+{
+  size_t i = 0;
+#ifdef FABRIC_DFG_CONVERSION_SSE2
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+    __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+    _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+  }
+#endif
+  for(; i < count; i++)
+    dst[i] = (float)src[i];
+}
+
+void dfgWidenFloat32ToFloat64(const float * src, double * dst, size_t count)
+{
+  size_t i = 0;
+#ifdef FABRIC_DFG_CONVERSION_SSE2
+  for(; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_loadu_ps(src + i);
+    _mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+    _mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+#endif
+  for(; i < count; i++)
+    dst[i] = (double)src[i];
+}
+
+void dfgPackFloat64x3ToFloat32x4(const double * src, float * dst, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    dst[i * 4 + 0] = (float)src[i * 3 + 0];
+    dst[i * 4 + 1] = (float)src[i * 3 + 1];
+    dst[i * 4 + 2] = (float)src[i * 3 + 2];
+  }
+}
+
+void dfgPackFloat32x3ToFloat32x4(const float * src, float * dst, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    dst[i * 4 + 0] = src[i * 3 + 0];
+    dst[i * 4 + 1] = src[i * 3 + 1];
+    dst[i * 4 + 2] = src[i * 3 + 2];
+  }
+}
+
+void dfgPackFloat32x3ToFloat64x4(const float * src, double * dst, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    dst[i * 4 + 0] = (double)src[i * 3 + 0];
+    dst[i * 4 + 1] = (double)src[i * 3 + 1];
+    dst[i * 4 + 2] = (double)src[i * 3 + 2];
+  }
+}
+
+void dfgPackFloat64x3ToFloat64x4(const double * src, double * dst, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    dst[i * 4 + 0] = src[i * 3 + 0];
+    dst[i * 4 + 1] = src[i * 3 + 1];
+    dst[i * 4 + 2] = src[i * 3 + 2];
+  }
+}
+
+void dfgUnpackFloat64x4ToFloat32x3(const double * src, float * dst, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    dst[i * 3 + 0] = (float)src[i * 4 + 0];
+    dst[i * 3 + 1] = (float)src[i * 4 + 1];
+    dst[i * 3 + 2] = (float)src[i * 4 + 2];
+  }
+}
+
+void dfgUnpackFloat64x4ToFloat64x3(const double * src, double * dst, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    dst[i * 3 + 0] = src[i * 4 + 0];
+    dst[i * 3 + 1] = src[i * 4 + 1];
+    dst[i * 3 + 2] = src[i * 4 + 2];
+  }
+}
+
+void dfgTransposeMat44(const double * src, double * dst, size_t count)
+{
+  for(size_t m = 0; m < count; m++, src += 16, dst += 16)
+  {
+#ifdef FABRIC_DFG_CONVERSION_SSE2
+    // transpose each of the four 2x2 blocks into its mirrored position
+    for(int r = 0; r < 4; r += 2)
+    {
+      for(int c = 0; c < 4; c += 2)
+      {
+        __m128d a = _mm_loadu_pd(src + r * 4 + c);
+        __m128d b = _mm_loadu_pd(src + (r + 1) * 4 + c);
+        _mm_storeu_pd(dst + c * 4 + r, _mm_unpacklo_pd(a, b));
+        _mm_storeu_pd(dst + (c + 1) * 4 + r, _mm_unpackhi_pd(a, b));
+      }
+    }
+#else
+    for(int r = 0; r < 4; r++)
+      for(int c = 0; c < 4; c++)
+        dst[c * 4 + r] = src[r * 4 + c];
+#endif
+  }
+}
+
+void dfgTransposeMat44(const float * src, float * dst, size_t count)
+{
+  for(size_t m = 0; m < count; m++, src += 16, dst += 16)
+  {
+#ifdef FABRIC_DFG_CONVERSION_SSE2
+    __m128 r0 = _mm_loadu_ps(src + 0);
+    __m128 r1 = _mm_loadu_ps(src + 4);
+    __m128 r2 = _mm_loadu_ps(src + 8);
+    __m128 r3 = _mm_loadu_ps(src + 12);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst + 0, r0);
+    _mm_storeu_ps(dst + 4, r1);
+    _mm_storeu_ps(dst + 8, r2);
+    _mm_storeu_ps(dst + 12, r3);
+#else
+    for(int r = 0; r < 4; r++)
+      for(int c = 0; c < 4; c++)
+        dst[c * 4 + r] = src[r * 4 + c];
+#endif
+  }
+}
+
+void dfgTransposeMat44(const double * src, float * dst, size_t count)
+{
+  for(size_t m = 0; m < count; m++, src += 16, dst += 16)
+  {
+#ifdef FABRIC_DFG_CONVERSION_SSE2
+    __m128 r0 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src + 0)),  _mm_cvtpd_ps(_mm_loadu_pd(src + 2)));
+    __m128 r1 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src + 4)),  _mm_cvtpd_ps(_mm_loadu_pd(src + 6)));
+    __m128 r2 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src + 8)),  _mm_cvtpd_ps(_mm_loadu_pd(src + 10)));
+    __m128 r3 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src + 12)), _mm_cvtpd_ps(_mm_loadu_pd(src + 14)));
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst + 0, r0);
+    _mm_storeu_ps(dst + 4, r1);
+    _mm_storeu_ps(dst + 8, r2);
+    _mm_storeu_ps(dst + 12, r3);
+#else
+    for(int r = 0; r < 4; r++)
+      for(int c = 0; c < 4; c++)
+        dst[c * 4 + r] = (float)src[r * 4 + c];
+#endif
+  }
+}
+
+void dfgTransposeMat44(const float * src, double * dst, size_t count)
+{
+  for(size_t m = 0; m < count; m++, src += 16, dst += 16)
+  {
+#ifdef FABRIC_DFG_CONVERSION_SSE2
+    __m128 r0 = _mm_loadu_ps(src + 0);
+    __m128 r1 = _mm_loadu_ps(src + 4);
+    __m128 r2 = _mm_loadu_ps(src + 8);
+    __m128 r3 = _mm_loadu_ps(src + 12);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_pd(dst + 0,  _mm_cvtps_pd(r0));
+    _mm_storeu_pd(dst + 2,  _mm_cvtps_pd(_mm_movehl_ps(r0, r0)));
+    _mm_storeu_pd(dst + 4,  _mm_cvtps_pd(r1));
+    _mm_storeu_pd(dst + 6,  _mm_cvtps_pd(_mm_movehl_ps(r1, r1)));
+    _mm_storeu_pd(dst + 8,  _mm_cvtps_pd(r2));
+    _mm_storeu_pd(dst + 10, _mm_cvtps_pd(_mm_movehl_ps(r2, r2)));
+    _mm_storeu_pd(dst + 12, _mm_cvtps_pd(r3));
+    _mm_storeu_pd(dst + 14, _mm_cvtps_pd(_mm_movehl_ps(r3, r3)));
+#else
+    for(int r = 0; r < 4; r++)
+      for(int c = 0; c < 4; c++)
+        dst[c * 4 + r] = (double)src[r * 4 + c];
+#endif
+  }
+}
@@ -0,0 +1,34 @@
+//
+// Copyright (c) 2010-2017 Fabric Software Inc. All rights reserved.
+//
+
+#pragma once
+
+#include <stddef.h>
+
+// Bulk precision conversions used when Maya's native array storage
+// (double precision) is moved to or from single precision KL arrays.
+// The count is the number of scalars, not the number of elements.
+void dfgNarrowFloat64ToFloat32(const double * src, float * dst, size_t count);
+void dfgWidenFloat32ToFloat64(const float * src, double * dst, size_t count);
+
+// Packs count 3 component vectors into 4 component float elements
+// (Color, Euler). The fourth component of each element is left untouched.
+void dfgPackFloat64x3ToFloat32x4(const double * src, float * dst, size_t count);
+void dfgPackFloat32x3ToFloat32x4(const float * src, float * dst, size_t count);
+
+// Moves count 3 component vectors to and from 4 component double
+// elements (MPoint). Packing leaves the fourth component of each element
+// untouched, unpacking drops it.
+void dfgPackFloat32x3ToFloat64x4(const float * src, double * dst, size_t count);
+void dfgPackFloat64x3ToFloat64x4(const double * src, double * dst, size_t count);
+void dfgUnpackFloat64x4ToFloat32x3(const double * src, float * dst, size_t count);
+void dfgUnpackFloat64x4ToFloat64x3(const double * src, double * dst, size_t count);
+
+// Transposes count 4x4 matrices between Maya's row major layout and
+// KL's Mat44 layout, converting the precision along the way. The
+// transpose is its own inverse, so the same kernels serve both directions.
+void dfgTransposeMat44(const double * src, double * dst, size_t count);
+void dfgTransposeMat44(const float * src, float * dst, size_t count);
+void dfgTransposeMat44(const double * src, float * dst, size_t count);
+void dfgTransposeMat44(const float * src, double * dst, size_t count);
@@ -11,12 +11,15 @@
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnNumericAttribute.h>
+#include <maya/MArrayDataHandle.h>
+#include <maya/MFnMesh.h>
 #include <maya/MFileIO.h>
 
 MObject FabricDFGMayaDeformer::saveData;
 MObject FabricDFGMayaDeformer::evalID;
 MObject FabricDFGMayaDeformer::refFilePath;
 MObject FabricDFGMayaDeformer::enableEvalContext;
+MObject FabricDFGMayaDeformer::batchDeform;
 
 FabricDFGMayaDeformer::FabricDFGMayaDeformer(
   FabricDFGBaseInterface::CreateDFGBindingFunc createDFGBinding
@@ -24,9 +27,11 @@ FabricDFGMayaDeformer::FabricDFGMayaDeformer(
   : FabricDFGBaseInterface( createDFGBinding )
 {
   mGeometryInitialized = 0;
+  mBatchEvaluated = false;
 }
 
 void FabricDFGMayaDeformer::postConstructor(){
+  FabricDFGBaseInterface::registerInstanceMObject();
   if(!MFileIO::isOpeningFile())
     FabricDFGBaseInterface::constructBaseInterface();
   setExistWithoutInConnections(true);
@@ -59,6 +64,11 @@ MStatus FabricDFGMayaDeformer::initialize(){
   nAttr.setConnectable(false);
   addAttribute(enableEvalContext);
 
+  batchDeform = nAttr.create("batchDeform", "bdf", MFnNumericData::kBoolean, 0.0);
+  nAttr.setHidden(true);
+  nAttr.setConnectable(false);
+  addAttribute(batchDeform);
+
   return MS::kSuccess;
 }
 
@@ -79,6 +89,15 @@ MStatus FabricDFGMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, cons
   {
     MAYADFG_CATCH_BEGIN(&stat);
 
+    // the binding can't be restored during the evaluation, since that
+    // changes the node's attributes. it is restored on idle instead, which
+    // invalidates the node again.
+    if(_restoreDeferred)
+    {
+      queueRestoreDeferredBinding();
+      return MS::kSuccess;
+    }
+
     FabricCore::DFGBinding binding = getDFGBinding();
     FabricCore::DFGExec    exec    = getDFGExec();
     if (!binding.isValid() || !exec.isValid())
@@ -92,6 +111,9 @@ MStatus FabricDFGMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, cons
       }
     }
 
+    if(block.inputValue(batchDeform).asBool())
+      return deformBatched(block, iter, multiIndex);
+
     if(transferInputValuesToDFG(block))
     {
       FabricCore::RTVal rtMesh, rtMeshes;
@@ -113,20 +135,24 @@ MStatus FabricDFGMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, cons
       if(!rtMesh.isValid() || rtMesh.isNullObject())
         return MStatus::kSuccess;
 
-      MPointArray mayaPoints;
-      iter.allPositions(mayaPoints);
+      // meshes deformed as a whole go through the float32 path,
+      // other geometries (nurbs, lattices, ...) through MPointArray.
+      MObject meshObj;
+      MDataHandle outputGeomHandle = getOutputGeomHandle(block, multiIndex);
+      bool useFloatPoints = dfgGetFullMesh(outputGeomHandle, iter, meshObj);
 
-      try
+      MPointArray mayaPoints;
+      if(useFloatPoints)
       {
-        std::vector<FabricCore::RTVal> args(2);
-        args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
-        args[1] = FabricSplice::constructUInt32RTVal(4); // components
-        rtMesh.callMethod("", "setPointsFromExternalArray_d", 2, &args[0]);
+        MFnMesh mesh(meshObj);
+        if(!dfgSetPolygonMeshPoints(rtMesh, mesh.getRawPoints(&stat), mesh.numVertices()))
+          return MStatus::kSuccess;
       }
-      catch(FabricCore::Exception e)
+      else
       {
-        mayaLogErrorFunc(e.getDesc_cstr());
-        return MStatus::kSuccess;
+        iter.allPositions(mayaPoints);
+        if(!dfgSetPolygonMeshPoints(rtMesh, mayaPoints))
+          return MStatus::kSuccess;
       }
       binding.setArgValue_lockType(getLockType(), portName.asChar(), rtMeshes, false);
 
@@ -143,20 +169,20 @@ MStatus FabricDFGMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, cons
       if(!rtMesh.isValid() || rtMesh.isNullObject())
         return MStatus::kSuccess;
 
-      try
+      if(useFloatPoints)
       {
-        std::vector<FabricCore::RTVal> args(2);
-        args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
-        args[1] = FabricSplice::constructUInt32RTVal(4); // components
-        rtMesh.callMethod("", "getPointsAsExternalArray_d", 2, &args[0]);
+        MFnMesh mesh(meshObj);
+        MFloatPointArray mayaFloatPoints(mesh.numVertices());
+        if(!dfgGetPolygonMeshPoints(rtMesh, mayaFloatPoints))
+          return MStatus::kSuccess;
+        mesh.setPoints(mayaFloatPoints);
       }
-      catch(FabricCore::Exception e)
+      else
       {
-        mayaLogErrorFunc(e.getDesc_cstr());
-        return MStatus::kSuccess;
+        if(!dfgGetPolygonMeshPoints(rtMesh, mayaPoints))
+          return MStatus::kSuccess;
+        iter.setAllPositions(mayaPoints);
       }
-
-      iter.setAllPositions(mayaPoints);
       transferOutputValuesToMaya(block, true);
     }
 
@@ -174,9 +200,180 @@ MStatus FabricDFGMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, cons
   return stat;
 }
 
+MStatus FabricDFGMayaDeformer::deformBatched(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex)
+{
+  FabricMayaProfilingEvent bracket("FabricDFGMayaDeformer::deformBatched");
+
+  // the binding has already been executed during this cycle,
+  // only copy this geometry's result back.
+  if(mBatchEvaluated && multiIndex < mBatchServed.size() && !mBatchServed[multiIndex])
+  {
+    mBatchServed[multiIndex] = true;
+    applyBatchPoints(block, iter, multiIndex);
+    return MStatus::kSuccess;
+  }
+
+  // a geometry asked twice starts a new cycle
+  mBatchEvaluated = false;
+
+  if(!transferInputValuesToDFG(block))
+    return MStatus::kSuccess;
+
+  FabricCore::DFGBinding binding = getDFGBinding();
+  FabricCore::DFGExec    exec    = getDFGExec();
+
+  MString portName = "meshes";
+  if (!exec.haveExecPort(portName.asChar()))
+    return MStatus::kSuccess;
+  if (exec.getExecPortType(portName.asChar()) != FabricCore::DFGPortType_IO)
+  { mayaLogFunc("FabricDFGMayaDeformer: port \"meshes\" is not an IO port");
+    return MStatus::kSuccess; }
+  if (exec.getExecPortResolvedType(portName.asChar()) != std::string("PolygonMesh[]"))
+  { mayaLogFunc("FabricDFGMayaDeformer: port \"meshes\" has the wrong resolved data type");
+    return MStatus::kSuccess; }
+
+  FabricCore::RTVal rtMeshes = binding.getArgValue(portName.asChar());
+  if(!rtMeshes.isValid()) return MStatus::kSuccess;
+  if(!rtMeshes.isArray()) return MStatus::kSuccess;
+
+  unsigned int nbMeshes = rtMeshes.getArraySize();
+  if(multiIndex >= nbMeshes)
+    return MStatus::kSuccess;
+
+  mBatchPoints.resize(nbMeshes);
+  mBatchFloatPoints.resize(nbMeshes);
+  mBatchServed.assign(nbMeshes, false);
+
+  // gather the points of every connected geometry
+  {
+    FabricMayaProfilingEvent bracket("gathering points");
+
+    MArrayDataHandle inputArrayHandle = block.inputArrayValue(input);
+    for(unsigned int i = 0; i < nbMeshes; ++i)
+    {
+      mBatchPoints[i].clear();
+      mBatchFloatPoints[i].clear();
+
+      FabricCore::RTVal rtMesh = rtMeshes.getArrayElement(i);
+      if(!rtMesh.isValid() || rtMesh.isNullObject())
+        continue;
+
+      MObject meshObj;
+      if(i == multiIndex)
+      {
+        MDataHandle outputGeomHandle = getOutputGeomHandle(block, i);
+        if(!dfgGetFullMesh(outputGeomHandle, iter, meshObj))
+          iter.allPositions(mBatchPoints[i]);
+      }
+      else
+      {
+        if(inputArrayHandle.jumpToElement(i) != MS::kSuccess)
+          continue;
+        MDataHandle inputElementHandle = inputArrayHandle.inputValue();
+        MDataHandle inputGeomHandle = inputElementHandle.child(inputGeom);
+        unsigned int inputGroupId = inputElementHandle.child(groupId).asInt();
+        MItGeometry inputIter(inputGeomHandle, inputGroupId, true /* readOnly */);
+        if(!dfgGetFullMesh(inputGeomHandle, inputIter, meshObj))
+          inputIter.allPositions(mBatchPoints[i]);
+      }
+
+      if(!meshObj.isNull())
+      {
+        MFnMesh mesh(meshObj);
+        mBatchFloatPoints[i].setLength(mesh.numVertices());
+        if(mBatchFloatPoints[i].length() == 0)
+          continue;
+        if(!dfgSetPolygonMeshPoints(rtMesh, mesh.getRawPoints(NULL), mesh.numVertices()))
+          mBatchFloatPoints[i].clear();
+        continue;
+      }
+
+      if(mBatchPoints[i].length() == 0)
+        continue;
+      if(!dfgSetPolygonMeshPoints(rtMesh, mBatchPoints[i]))
+        mBatchPoints[i].clear();
+    }
+  }
+
+  binding.setArgValue_lockType(getLockType(), portName.asChar(), rtMeshes, false);
+
+  evaluate();
+
+  // [FE-7528] the graph could have replaced the meshes, fetch them again.
+  rtMeshes = binding.getArgValue(portName.asChar());
+  if(!rtMeshes.isValid()) return MStatus::kSuccess;
+  if(!rtMeshes.isArray()) return MStatus::kSuccess;
+
+  {
+    FabricMayaProfilingEvent bracket("fetching points");
+
+    unsigned int nbResults = rtMeshes.getArraySize();
+    for(unsigned int i = 0; i < nbMeshes; ++i)
+    {
+      if(mBatchPoints[i].length() == 0 && mBatchFloatPoints[i].length() == 0)
+        continue;
+
+      FabricCore::RTVal rtMesh;
+      if(i < nbResults)
+        rtMesh = rtMeshes.getArrayElement(i);
+      if(!rtMesh.isValid() || rtMesh.isNullObject())
+      {
+        mBatchPoints[i].clear();
+        mBatchFloatPoints[i].clear();
+      }
+      else if(mBatchFloatPoints[i].length() > 0)
+      {
+        if(!dfgGetPolygonMeshPoints(rtMesh, mBatchFloatPoints[i]))
+          mBatchFloatPoints[i].clear();
+      }
+      else if(!dfgGetPolygonMeshPoints(rtMesh, mBatchPoints[i]))
+        mBatchPoints[i].clear();
+    }
+  }
+
+  transferOutputValuesToMaya(block, true);
+
+  mBatchEvaluated = true;
+  mBatchServed[multiIndex] = true;
+  applyBatchPoints(block, iter, multiIndex);
+
+  return MStatus::kSuccess;
+}
+
+void FabricDFGMayaDeformer::applyBatchPoints(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex)
+{
+  if(mBatchFloatPoints[multiIndex].length() > 0)
+  {
+    MObject meshObj;
+    MDataHandle outputGeomHandle = getOutputGeomHandle(block, multiIndex);
+    if(dfgGetFullMesh(outputGeomHandle, iter, meshObj))
+    {
+      MFnMesh mesh(meshObj);
+      if(mesh.numVertices() == (int)mBatchFloatPoints[multiIndex].length())
+      {
+        mesh.setPoints(mBatchFloatPoints[multiIndex]);
+        return;
+      }
+    }
+  }
+
+  if(mBatchPoints[multiIndex].length() > 0)
+    iter.setAllPositions(mBatchPoints[multiIndex]);
+}
+
+MDataHandle FabricDFGMayaDeformer::getOutputGeomHandle(MDataBlock& block, unsigned int multiIndex)
+{
+  MArrayDataHandle outputArrayHandle = block.outputArrayValue(outputGeom);
+  if(outputArrayHandle.jumpToElement(multiIndex) != MS::kSuccess)
+    return MDataHandle();
+  return outputArrayHandle.outputValue();
+}
+
 MStatus FabricDFGMayaDeformer::setDependentsDirty(MPlug const &inPlug, MPlugArray &affectedPlugs){
   MStatus stat = FabricDFGBaseInterface::setDependentsDirty(thisMObject(), inPlug, affectedPlugs);
 
+  resetBatch();
+
   MFnDependencyNode thisNode(thisMObject());
   MPlug output = thisNode.findPlug("outputGeometry");
   affectedPlugs.append(output);
@@ -202,6 +399,7 @@ void FabricDFGMayaDeformer::invalidateNode()
   }
 
   mGeometryInitialized = false;
+  resetBatch();
 }
 
 MStatus FabricDFGMayaDeformer::shouldSave(const MPlug &plug, bool &isSaving){
@@ -273,6 +471,8 @@ MStatus FabricDFGMayaDeformer::preEvaluation(
   const MEvaluationNode& evaluationNode
   )
 {
+  resetBatch();
+
   return FabricDFGBaseInterface::doPreEvaluation(
     thisMObject(),
     context,
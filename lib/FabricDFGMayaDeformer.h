@@ -9,6 +9,8 @@
 #include <maya/MPxDeformerNode.h>
 #include <maya/MTypeId.h>
 #include <maya/MItGeometry.h>
+#include <maya/MPointArray.h>
+#include <maya/MFloatPointArray.h>
 #include <maya/MNodeMessage.h>
 #include <maya/MStringArray.h>
 
@@ -31,6 +33,7 @@ public:
   virtual MPlug getSaveDataPlug() { return MPlug(thisMObject(), saveData); }
   virtual MPlug getRefFilePathPlug() { return MPlug(thisMObject(), refFilePath); }
   virtual MPlug getEnableEvalContextPlug() { return MPlug(thisMObject(), enableEvalContext); }
+  virtual MPlug getEvalIDPlug() { return MPlug(thisMObject(), evalID); }
 
   MStatus deform(MDataBlock& block, MItGeometry& iter, const MMatrix&, unsigned int multiIndex);
   MStatus setDependentsDirty(MPlug const &inPlug, MPlugArray &affectedPlugs);
@@ -76,6 +79,7 @@ public:
   static MObject evalID;
   static MObject refFilePath;
   static MObject enableEvalContext;
+  static MObject batchDeform;
 
 protected:
   virtual void invalidateNode();
@@ -85,4 +89,17 @@ private:
   int initializePolygonMeshPorts(MPlug &meshPlug, MDataBlock &data);
   // void initializeGeometry(MObject &meshObj);
   int mGeometryInitialized;
+
+  // batched deformation: the first deform() call of a cycle gathers
+  // the points of all connected geometries, executes the binding once
+  // and caches the results for the remaining deform() calls.
+  MStatus deformBatched(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex);
+  void applyBatchPoints(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex);
+  void resetBatch() { mBatchEvaluated = false; }
+  bool mBatchEvaluated;
+  std::vector<MPointArray> mBatchPoints;
+  std::vector<MFloatPointArray> mBatchFloatPoints;
+  std::vector<bool> mBatchServed;
+
+  MDataHandle getOutputGeomHandle(MDataBlock& block, unsigned int multiIndex);
 };
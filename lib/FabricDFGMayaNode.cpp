@@ -11,11 +11,15 @@
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFileIO.h>
+#include <maya/MAnimControl.h>
+#include <maya/MDGContext.h>
 
 MObject FabricDFGMayaNode::saveData;
 MObject FabricDFGMayaNode::evalID;
 MObject FabricDFGMayaNode::refFilePath;
 MObject FabricDFGMayaNode::enableEvalContext;
+MObject FabricDFGMayaNode::playbackCache;
+MObject FabricDFGMayaNode::playbackCacheMemory;
 
 FabricDFGMayaNode::FabricDFGMayaNode(
   FabricDFGBaseInterface::CreateDFGBindingFunc createDFGBinding
@@ -25,6 +29,7 @@ FabricDFGMayaNode::FabricDFGMayaNode(
 }
 
 void FabricDFGMayaNode::postConstructor(){
+  FabricDFGBaseInterface::registerInstanceMObject();
   if(!MFileIO::isOpeningFile())
     FabricDFGBaseInterface::constructBaseInterface();
   setExistWithoutInConnections(true);
@@ -59,6 +64,20 @@ MStatus FabricDFGMayaNode::initialize(){
   nAttr.setConnectable(false);
   addAttribute(enableEvalContext);
 
+  // opt-in cache of the outputs and io ports per frame, the memory is given in MB.
+  // only inputs connected directly to the time node or to a time based anim curve
+  // keep the cached frames valid, any other input change flushes the cache.
+  playbackCache = nAttr.create("playbackCache", "pbc", MFnNumericData::kBoolean, 0.0);
+  nAttr.setHidden(true);
+  nAttr.setConnectable(false);
+  addAttribute(playbackCache);
+
+  playbackCacheMemory = nAttr.create("playbackCacheMemory", "pbm", MFnNumericData::kInt, 512);
+  nAttr.setMin(0);
+  nAttr.setHidden(true);
+  nAttr.setConnectable(false);
+  addAttribute(playbackCacheMemory);
+
   return MS::kSuccess;
 }
 
@@ -81,13 +100,47 @@ MStatus FabricDFGMayaNode::compute(const MPlug& plug, MDataBlock& data){
   {
     MAYADFG_CATCH_BEGIN(&stat);
 
+    // the binding can't be restored during the evaluation, since that
+    // changes the node's attributes. it is restored on idle instead, which
+    // invalidates the node again.
+    if(_restoreDeferred)
+    {
+      queueRestoreDeferredBinding();
+      return MS::kSuccess;
+    }
+
     // if(!_spliceGraph.checkErrors()){
     //   return MStatus::kFailure; // avoid evaluating on errors
     // }
 
-    if(transferInputValuesToDFG(data))
+    // frames which have been evaluated with the same inputs
+    // before are served from the playback cache directly. the cache
+    // is keyed by the time of the normal context only, evaluations in
+    // any other context (getAttr -t, motion blur, background evaluation)
+    // bypass it.
+    bool usePlaybackCache = data.inputValue(playbackCache).asBool();
+    if(!usePlaybackCache)
+      clearPlaybackCache();
+    MDGContext context = data.context();
+    if(!context.isNormal())
+      usePlaybackCache = false;
+    MTime contextTime;
+    if(!context.getTime(contextTime))
+      contextTime = MAnimControl::currentTime();
+    double time = contextTime.as(MTime::kSeconds);
+
+    if(usePlaybackCache && restoreOutputsFromPlaybackCache(time))
+    {
+      transferOutputValuesToMaya(data);
+    }
+    else if(transferInputValuesToDFG(data))
     {
       evaluate();
+      if(usePlaybackCache)
+      {
+        size_t memoryBudget = size_t(data.inputValue(playbackCacheMemory).asInt()) * 1024 * 1024;
+        storeOutputsInPlaybackCache(time, memoryBudget);
+      }
       transferOutputValuesToMaya(data);
     }
 
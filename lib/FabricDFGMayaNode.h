@@ -30,6 +30,7 @@ public:
   virtual MPlug getSaveDataPlug() { return MPlug(thisMObject(), saveData); }
   virtual MPlug getRefFilePathPlug() { return MPlug(thisMObject(), refFilePath); }
   virtual MPlug getEnableEvalContextPlug() { return MPlug(thisMObject(), enableEvalContext); }
+  virtual MPlug getEvalIDPlug() { return MPlug(thisMObject(), evalID); }
 
   MStatus compute(const MPlug& plug, MDataBlock& data);
   MStatus setDependentsDirty(MPlug const &inPlug, MPlugArray &affectedPlugs);
@@ -60,4 +61,6 @@ public:
   static MObject evalID;
   static MObject refFilePath;
   static MObject enableEvalContext;
+  static MObject playbackCache;
+  static MObject playbackCacheMemory;
 };
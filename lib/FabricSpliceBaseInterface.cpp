@@ -30,12 +30,15 @@
 #include <maya/MFileObject.h>
 #include <maya/MFnPluginData.h>
 #include <maya/MAnimControl.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MSelectionList.h>
 
 #if MAYA_API_VERSION >= 201600
 # include <maya/MEvaluationNode.h>
 #endif
 
 std::vector<FabricSpliceBaseInterface*> FabricSpliceBaseInterface::_instances;
+std::multimap<unsigned int, FabricSpliceBaseInterface*> FabricSpliceBaseInterface::_instancesByHashCode;
 #if MAYA_API_VERSION < 201300
   std::map<std::string, int> FabricSpliceBaseInterface::_nodeCreatorCounts;
 #endif
@@ -51,6 +54,8 @@ FabricSpliceBaseInterface::FabricSpliceBaseInterface(){
   _spliceGraph.setUserPointer(this);
   _isTransferingInputs = false;
   _instances.push_back(this);
+  _hasHashCode = false;
+  _hashCode = 0;
   _dgDirtyEnabled = true;
   _portObjectsDestroyed = false;
   _affectedPlugsDirty = true;
@@ -69,6 +74,28 @@ FabricSpliceBaseInterface::~FabricSpliceBaseInterface(){
       break;
     }
   }
+
+  if(_hasHashCode)
+  {
+    std::multimap<unsigned int, FabricSpliceBaseInterface*>::iterator it = _instancesByHashCode.lower_bound(_hashCode);
+    for(;it != _instancesByHashCode.end() && it->first == _hashCode;it++)
+    {
+      if(it->second == this)
+      {
+        _instancesByHashCode.erase(it);
+        break;
+      }
+    }
+  }
+}
+
+void FabricSpliceBaseInterface::registerInstanceMObject()
+{
+  if(_hasHashCode)
+    return;
+  _hashCode = MObjectHandle(getThisMObject()).hashCode();
+  _hasHashCode = true;
+  _instancesByHashCode.insert(std::pair<unsigned int, FabricSpliceBaseInterface*>(_hashCode, this));
 }
 
 void FabricSpliceBaseInterface::constructBaseInterface(){
@@ -112,17 +139,36 @@ FabricSpliceBaseInterface * FabricSpliceBaseInterface::getInstanceByName(const s
   MGlobal::getSelectionListByName(name.c_str(), selList);
   MObject spliceMayaNodeObj;
   selList.getDependNode(0, spliceMayaNodeObj);
+  return getInstanceByMObject(spliceMayaNodeObj);
+}
+
+FabricSpliceBaseInterface * FabricSpliceBaseInterface::getInstanceByMObject(const MObject & obj) {
+
+  if(obj.isNull())
+    return NULL;
 
-  for(size_t i=0;i<_instances.size();i++)
+  unsigned int hashCode = MObjectHandle(obj).hashCode();
+  std::multimap<unsigned int, FabricSpliceBaseInterface*>::iterator it = _instancesByHashCode.lower_bound(hashCode);
+  for(;it != _instancesByHashCode.end() && it->first == hashCode;it++)
   {
-    if(_instances[i]->getThisMObject() == spliceMayaNodeObj)
-    {
-      return _instances[i];
-    }
+    if(it->second->getThisMObject() == obj)
+      return it->second;
   }
   return NULL;
 }
 
+#if MAYA_API_VERSION >= 201600
+FabricSpliceBaseInterface * FabricSpliceBaseInterface::getInstanceByUuid(const MUuid & uuid) {
+
+  MSelectionList selList;
+  if(selList.add(uuid) != MS::kSuccess)
+    return NULL;
+  MObject obj;
+  selList.getDependNode(0, obj);
+  return getInstanceByMObject(obj);
+}
+#endif
+
 bool FabricSpliceBaseInterface::transferInputValuesToSplice(
   MDataBlock& data
   )
@@ -1349,7 +1395,7 @@ MStatus FabricSpliceBaseInterface::setDependentsDirty(
 }
 
 void FabricSpliceBaseInterface::copyInternalData(MPxNode *node){
-  FabricSpliceBaseInterface *otherSpliceInterface = getInstanceByName(node->name().asChar());
+  FabricSpliceBaseInterface *otherSpliceInterface = getInstanceByMObject(node->thisMObject());
 
   std::string jsonData = otherSpliceInterface->_spliceGraph.getPersistenceDataJSON();
   _spliceGraph.setFromPersistenceDataJSON(jsonData.c_str());
@@ -1361,16 +1407,14 @@ void FabricSpliceBaseInterface::setPortPersistence(const MString &portName, bool
 
 void FabricSpliceBaseInterface::onNodeAdded(MObject &node, void *clientData)
 {
-  MFnDependencyNode thisNode(node);
-  FabricSpliceBaseInterface * interf = getInstanceByName(thisNode.name().asChar());
+  FabricSpliceBaseInterface * interf = getInstanceByMObject(node);
   if(interf)
     interf->managePortObjectValues(false); // reattach
 }
 
 void FabricSpliceBaseInterface::onNodeRemoved(MObject &node, void *clientData)
 {
-  MFnDependencyNode thisNode(node);
-  FabricSpliceBaseInterface * interf = getInstanceByName(thisNode.name().asChar());
+  FabricSpliceBaseInterface * interf = getInstanceByMObject(node);
   if(interf)
     interf->managePortObjectValues(true); // detach
 }
@@ -7,6 +7,7 @@
 #include "FabricSpliceConversion.h"
 
 #include <vector>
+#include <map>
 
 #include <maya/MFnDependencyNode.h> 
 #include <maya/MPlug.h> 
@@ -15,6 +16,9 @@
 #include <maya/MNodeMessage.h>
 #include <maya/MStringArray.h>
 #include <maya/MFnCompoundAttribute.h>
+#if MAYA_API_VERSION >= 201600
+# include <maya/MUuid.h>
+#endif
 
 #include <FabricSplice.h>
 
@@ -42,12 +46,18 @@ public:
   FabricSpliceBaseInterface();
   virtual ~FabricSpliceBaseInterface();
   void constructBaseInterface();
+  // to be called from the postConstructor, once the MObject is valid
+  void registerInstanceMObject();
 
   virtual MObject getThisMObject() = 0;
   virtual MPlug getSaveDataPlug() = 0;
 
   static std::vector<FabricSpliceBaseInterface*> getInstances();
   static FabricSpliceBaseInterface * getInstanceByName(const std::string & name);
+  static FabricSpliceBaseInterface * getInstanceByMObject(const MObject & obj);
+#if MAYA_API_VERSION >= 201600
+  static FabricSpliceBaseInterface * getInstanceByUuid(const MUuid & uuid);
+#endif
 
   MObject addMayaAttribute(const MString &portName, const MString &dataType, const MString &arrayType, const FabricSplice::Port_Mode &portMode, bool compoundChild = false, FabricCore::Variant compoundStructure = FabricCore::Variant(), MStatus *stat = 0);
   void addPort(const MString &portName, const MString &dataType, const FabricSplice::Port_Mode &portMode, const MString & dgNode, bool autoInitObjects, const MString & extension, const FabricCore::Variant & defaultValue, MStatus *stat = 0);
@@ -93,6 +103,10 @@ protected:
 
   // private members and helper methods
   static std::vector<FabricSpliceBaseInterface*> _instances;
+  // the instances indexed by the hash code of their MObject
+  static std::multimap<unsigned int, FabricSpliceBaseInterface*> _instancesByHashCode;
+  bool _hasHashCode;
+  unsigned int _hashCode;
   bool _restoredFromPersistenceData;
   unsigned int _dummyValue;
 
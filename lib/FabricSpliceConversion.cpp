@@ -33,6 +33,8 @@
 #include <maya/MFnNurbsCurveData.h>
 #include <maya/MFloatVectorArray.h>
 #include <maya/MFnAnimCurve.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MMutexLock.h>
 
 #define CORE_CATCH_BEGIN try {
 #define CORE_CATCH_END } \
@@ -1394,54 +1396,71 @@ void plugToPort_Lines(MPlug &plug, MDataBlock &data, FabricSplice::DGPort & port
   }
 }
 
-void plugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal & trackVal) {
+// converted tracks per anim curve, invalidated when the curve is edited.
+struct KeyframeTrackCacheEntry
+{
+  MObjectHandle curve;
+  MString name;
+  FabricCore::RTVal trackVal;
+};
+static std::map<unsigned int, KeyframeTrackCacheEntry> s_keyframeTrackCache;
+static MMutexLock s_keyframeTrackCacheLock;
 
-  CORE_CATCH_BEGIN;
+// expects s_keyframeTrackCacheLock to be locked
+static void pruneKeyframeTrackCache()
+{
+  // drop the entries of deleted curves
+  std::map<unsigned int, KeyframeTrackCacheEntry>::iterator it = s_keyframeTrackCache.begin();
+  while(it != s_keyframeTrackCache.end())
+  {
+    if(!it->second.curve.isAlive())
+      s_keyframeTrackCache.erase(it++);
+    else
+      ++it;
+  }
+}
 
-  // find the usage of this plug
-  // with this we might be able to determine color
-  MString curveName = curve.name();
-  double red, green, blue;
-  red = green = blue = 0.0;
-  if(curveName.indexW("_translateX") > -1 || curveName.indexW("_rotateX") > -1 || curveName.indexW("_scaleX") > -1)
-    red = 1.0;
-  else if(curveName.indexW("_translateY") > -1 || curveName.indexW("_rotateY") > -1 || curveName.indexW("_scaleY") > -1)
-    green = 1.0;
-  else if(curveName.indexW("_translateZ") > -1 || curveName.indexW("_rotateZ") > -1 || curveName.indexW("_scaleZ") > -1)
-    blue = 1.0;
+void plugToPort_KeyframeTrack_invalidate(MObject curveObj)
+{
+  MObjectHandle curveHandle(curveObj);
+  s_keyframeTrackCacheLock.lock();
+  s_keyframeTrackCache.erase(curveHandle.hashCode());
+  pruneKeyframeTrackCache();
+  s_keyframeTrackCacheLock.unlock();
+}
 
-  trackVal = FabricSplice::constructObjectRTVal("KeyframeTrack");
-  FabricCore::RTVal keysVal = trackVal.maybeGetMember("keys");
-  FabricCore::RTVal colorVal = FabricSplice::constructRTVal("Color");
-  FabricCore::RTVal numKeysVal = FabricSplice::constructUInt32RTVal(curve.numKeys());
-  keysVal.callMethod("", "resize", 1, &numKeysVal);
+// the layout of the KL Keyframe struct. the keys are packed on the Maya
+// side and copied into the track's Keyframe[] in one go.
+struct SpliceKeyframe
+{
+  float time;
+  float value;
+  float inTangent[2];
+  float outTangent[2];
+  int interpolation;
+};
 
-  trackVal.setMember("name", FabricSplice::constructStringRTVal(curveName.asChar()));
-  colorVal.setMember("r", FabricSplice::constructFloat64RTVal(red));
-  colorVal.setMember("g", FabricSplice::constructFloat64RTVal(green));
-  colorVal.setMember("b", FabricSplice::constructFloat64RTVal(blue));
-  colorVal.setMember("a", FabricSplice::constructFloat64RTVal(1.0));
-  trackVal.setMember("color", colorVal);
-  trackVal.setMember("defaultInterpolation", FabricSplice::constructSInt32RTVal(2));
-  trackVal.setMember("defaultValue", FabricSplice::constructFloat64RTVal(0.0));
+static void packAnimCurveKeys(MFnAnimCurve & curve, std::vector<SpliceKeyframe> & keys)
+{
+  unsigned int numKeys = curve.numKeys();
+  keys.resize(numKeys);
 
   bool weighted = curve.isWeighted();
 
-  for(unsigned int i=0;i<curve.numKeys();i++)
+  double prevKeyTime = 0.0;
+  double keyTime = numKeys > 0 ? curve.time(0).as(MTime::kSeconds) : 0.0;
+  for(unsigned int i=0;i<numKeys;i++)
   {
-    FabricCore::RTVal keyVal = FabricSplice::constructRTVal("Keyframe");
-    FabricCore::RTVal inTangentVal = FabricSplice::constructRTVal("Vec2");
-    FabricCore::RTVal outTangentVal = FabricSplice::constructRTVal("Vec2");
+    SpliceKeyframe & key = keys[i];
+    key.inTangent[0] = key.inTangent[1] = 0.0f;
+    key.outTangent[0] = key.outTangent[1] = 0.0f;
+    double nextKeyTime = i < numKeys-1 ? curve.time(i+1).as(MTime::kSeconds) : 0.0;
 
-    // Integer interpolation;
-    double keyTime = curve.time(i).as(MTime::kSeconds);
-    double keyValue = curve.value(i);
-    keyVal.setMember("time", FabricSplice::constructFloat64RTVal(keyTime));
-    keyVal.setMember("value", FabricSplice::constructFloat64RTVal(keyValue));
+    key.time = float(keyTime);
+    key.value = float(curve.value(i));
 
     if(i > 0)
     {
-      double prevKeyTime = curve.time(i-1).as(MTime::kSeconds);
       double timeDelta = keyTime - prevKeyTime;
       
       float x,y;
@@ -1460,15 +1479,13 @@ void plugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal & t
         weight = (x*-1.0/3.0)/timeDelta;
       if(fabs(x) > 0.0001)
         gradient = y/x;
-        //gradient = ((y*1.0/3.0)/valueDelta)/((x*1.0/3.0)/timeDelta);
 
-      inTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(weight));
-      inTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(gradient));
+      key.inTangent[0] = weight;
+      key.inTangent[1] = gradient;
     }
 
-    if(i < curve.numKeys()-1)
+    if(i < numKeys-1)
     {
-      double nextKeyTime = curve.time(i+1).as(MTime::kSeconds);
       double timeDelta = nextKeyTime - keyTime;
       
       float x,y;
@@ -1480,32 +1497,140 @@ void plugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal & t
       // Weighted out tangents are defined as 3*(P2 - P1),
       // So multiplly by 1/3 to get P2, and then divide by timeDelta
       // to get the ratio stored by the Fabric Engine keyframes.
-      // Also note that the default value of 1/3 for the handle weight 
-      // will create equally spaced handles, effectively the same as
-      // Maya's non-weighted curves.
       if(weighted && fabs(timeDelta) > 0.0001)
         weight = (x*1.0/3.0)/timeDelta;
       if(fabs(x) > 0.0001)
         gradient = y/x;
-        //gradient = ((y*1.0/3.0)/valueDelta)/((x*1.0/3.0)/timeDelta);
-      
-      outTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(weight));
-      outTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(gradient));
+
+      key.outTangent[0] = weight;
+      key.outTangent[1] = gradient;
     }
 
-    keyVal.setMember("inTangent", inTangentVal);
-    keyVal.setMember("outTangent", outTangentVal);
     int interpolation = 2;
-    if(curve.outTangentType(i) == MFnAnimCurve::kTangentFlat)
+    MFnAnimCurve::TangentType tangentType = curve.outTangentType(i);
+    if(tangentType == MFnAnimCurve::kTangentFlat)
       interpolation = 0;
-    else if(curve.outTangentType(i) == MFnAnimCurve::kTangentLinear)
+    else if(tangentType == MFnAnimCurve::kTangentLinear)
       interpolation = 1;
-    keyVal.setMember("interpolation", FabricSplice::constructSInt32RTVal(interpolation));
-    keysVal.setArrayElement(i, keyVal);
+    key.interpolation = interpolation;
+
+    prevKeyTime = keyTime;
+    keyTime = nextKeyTime;
   }
+}
 
+// the keys can only be copied as they are if the KL Keyframe
+// matches SpliceKeyframe, otherwise they are set one by one.
+static bool keyframeLayoutMatches()
+{
+  static int s_matches = -1;
+  if(s_matches < 0)
+  {
+    FabricCore::RTVal keyVal = FabricSplice::constructRTVal("Keyframe");
+    s_matches =
+      MString(keyVal.maybeGetMember("time").getTypeNameCStr()) == "Float32" &&
+      MString(keyVal.maybeGetMember("value").getTypeNameCStr()) == "Float32" &&
+      MString(keyVal.maybeGetMember("inTangent").getTypeNameCStr()) == "Vec2" &&
+      MString(keyVal.maybeGetMember("outTangent").getTypeNameCStr()) == "Vec2" &&
+      MString(keyVal.maybeGetMember("interpolation").getTypeNameCStr()) == "SInt32" ? 1 : 0;
+  }
+  return s_matches == 1;
+}
+
+static void setKeyframes(FabricCore::RTVal & keysVal, const std::vector<SpliceKeyframe> & keys)
+{
+  FabricCore::RTVal numKeysVal = FabricSplice::constructUInt32RTVal((unsigned int)keys.size());
+  keysVal.callMethod("", "resize", 1, &numKeysVal);
+  if(keys.size() == 0)
+    return;
+
+  if(keyframeLayoutMatches())
+  {
+    FabricCore::RTVal dataRtVal = keysVal.callMethod("Data", "data", 0, 0);
+    memcpy(dataRtVal.getData(), &keys[0], sizeof(SpliceKeyframe) * keys.size());
+    return;
+  }
+
+  for(size_t i=0;i<keys.size();i++)
+  {
+    const SpliceKeyframe & key = keys[i];
+    FabricCore::RTVal keyVal = FabricSplice::constructRTVal("Keyframe");
+    FabricCore::RTVal inTangentVal = FabricSplice::constructRTVal("Vec2");
+    FabricCore::RTVal outTangentVal = FabricSplice::constructRTVal("Vec2");
+    keyVal.setMember("time", FabricSplice::constructFloat64RTVal(key.time));
+    keyVal.setMember("value", FabricSplice::constructFloat64RTVal(key.value));
+    inTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(key.inTangent[0]));
+    inTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(key.inTangent[1]));
+    outTangentVal.setMember("x", FabricSplice::constructFloat64RTVal(key.outTangent[0]));
+    outTangentVal.setMember("y", FabricSplice::constructFloat64RTVal(key.outTangent[1]));
+    keyVal.setMember("inTangent", inTangentVal);
+    keyVal.setMember("outTangent", outTangentVal);
+    keyVal.setMember("interpolation", FabricSplice::constructSInt32RTVal(key.interpolation));
+    keysVal.setArrayElement((unsigned int)i, keyVal);
+  }
+}
+
+void plugToPort_KeyframeTrack_helper(MFnAnimCurve & curve, FabricCore::RTVal & trackVal, bool useCache = false) {
+
+  MString curveName = curve.name();
+  MObjectHandle curveHandle(curve.object());
+
+  if(useCache)
+  {
+    s_keyframeTrackCacheLock.lock();
+    std::map<unsigned int, KeyframeTrackCacheEntry>::iterator it = s_keyframeTrackCache.find(curveHandle.hashCode());
+    if(it != s_keyframeTrackCache.end() && it->second.curve == curveHandle && it->second.name == curveName)
+      trackVal = it->second.trackVal;
+    s_keyframeTrackCacheLock.unlock();
+    if(trackVal.isValid())
+      return;
+  }
+
+  CORE_CATCH_BEGIN;
+
+  // find the usage of this plug
+  // with this we might be able to determine color
+  double red, green, blue;
+  red = green = blue = 0.0;
+  if(curveName.indexW("_translateX") > -1 || curveName.indexW("_rotateX") > -1 || curveName.indexW("_scaleX") > -1)
+    red = 1.0;
+  else if(curveName.indexW("_translateY") > -1 || curveName.indexW("_rotateY") > -1 || curveName.indexW("_scaleY") > -1)
+    green = 1.0;
+  else if(curveName.indexW("_translateZ") > -1 || curveName.indexW("_rotateZ") > -1 || curveName.indexW("_scaleZ") > -1)
+    blue = 1.0;
+
+  trackVal = FabricSplice::constructObjectRTVal("KeyframeTrack");
+  FabricCore::RTVal colorVal = FabricSplice::constructRTVal("Color");
+
+  trackVal.setMember("name", FabricSplice::constructStringRTVal(curveName.asChar()));
+  colorVal.setMember("r", FabricSplice::constructFloat64RTVal(red));
+  colorVal.setMember("g", FabricSplice::constructFloat64RTVal(green));
+  colorVal.setMember("b", FabricSplice::constructFloat64RTVal(blue));
+  colorVal.setMember("a", FabricSplice::constructFloat64RTVal(1.0));
+  trackVal.setMember("color", colorVal);
+  trackVal.setMember("defaultInterpolation", FabricSplice::constructSInt32RTVal(2));
+  trackVal.setMember("defaultValue", FabricSplice::constructFloat64RTVal(0.0));
+
+  // the keys are packed on the Maya side and
+  // handed over to KL in one go.
+  std::vector<SpliceKeyframe> keys;
+  packAnimCurveKeys(curve, keys);
+
+  FabricCore::RTVal keysVal = trackVal.maybeGetMember("keys");
+  setKeyframes(keysVal, keys);
   trackVal.setMember("keys", keysVal);
 
+  if(useCache)
+  {
+    s_keyframeTrackCacheLock.lock();
+    KeyframeTrackCacheEntry & entry = s_keyframeTrackCache[curveHandle.hashCode()];
+    entry.curve = curveHandle;
+    entry.name = curveName;
+    entry.trackVal = trackVal;
+    pruneKeyframeTrackCache();
+    s_keyframeTrackCacheLock.unlock();
+  }
+
   CORE_CATCH_END;
 }
 
@@ -1528,8 +1653,9 @@ void plugToPort_KeyframeTrack(MPlug &plug, MDataBlock &data, FabricSplice::DGPor
     if(curve.object().isNull())
       return;
 
+    // IO ports can be modified by the graph, so they don't share the cached tracks
     FabricCore::RTVal trackVal;
-    plugToPort_KeyframeTrack_helper(curve, trackVal);
+    plugToPort_KeyframeTrack_helper(curve, trackVal, port.getMode() == FabricSplice::Port_Mode_IN);
     port.setRTVal(trackVal);
   } else {
 
@@ -1557,7 +1683,7 @@ void plugToPort_KeyframeTrack(MPlug &plug, MDataBlock &data, FabricSplice::DGPor
         continue;
 
       FabricCore::RTVal trackVal;
-      plugToPort_KeyframeTrack_helper(curve, trackVal);
+      plugToPort_KeyframeTrack_helper(curve, trackVal, port.getMode() == FabricSplice::Port_Mode_IN);
 
       trackVals.setArrayElement(j, trackVal);
     }
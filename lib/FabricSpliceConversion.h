@@ -63,3 +63,6 @@ SplicePortToPlugFunc getSplicePortToPlugFunc(
   const std::string & dataType, 
   const FabricSplice::DGPort * port = NULL
   );
+
+// drops the cached KeyframeTrack of the given anim curve
+void plugToPort_KeyframeTrack_invalidate(MObject curveObj);
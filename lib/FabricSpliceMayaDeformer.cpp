@@ -5,24 +5,29 @@
 #include "FabricSpliceEditorWidget.h"
 #include "FabricSpliceMayaDeformer.h"
 #include "FabricSpliceHelpers.h"
+#include "FabricDFGConversion.h"
 
 #include <maya/MGlobal.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MFnTypedAttribute.h>
 #include <maya/MPointArray.h>
+#include <maya/MFloatPointArray.h>
 #include <maya/MItMeshVertex.h>
 #include <maya/MFnMesh.h>
 #include <maya/MItMeshEdge.h>
 #include <maya/MItMeshPolygon.h>
+#include <maya/MArrayDataHandle.h>
 
 MTypeId FabricSpliceMayaDeformer::id(0x0011AE42);
 MObject FabricSpliceMayaDeformer::saveData;
 MObject FabricSpliceMayaDeformer::evalID;
+MObject FabricSpliceMayaDeformer::batchDeform;
 
 FabricSpliceMayaDeformer::FabricSpliceMayaDeformer()
 : FabricSpliceBaseInterface()
 {
   mGeometryInitialized = 0;
+  mBatchEvaluated = false;
 }
 
 FabricSpliceMayaDeformer::~FabricSpliceMayaDeformer()
@@ -31,6 +36,7 @@ FabricSpliceMayaDeformer::~FabricSpliceMayaDeformer()
 
 void FabricSpliceMayaDeformer::postConstructor()
 {
+  FabricSpliceBaseInterface::registerInstanceMObject();
   FabricSpliceBaseInterface::constructBaseInterface();
 
   MObject object = thisMObject();
@@ -67,6 +73,11 @@ MStatus FabricSpliceMayaDeformer::initialize(){
   numericAttr.setCached(false);
   addAttribute(evalID);
 
+  batchDeform = numericAttr.create("batchDeform", "bdf", MFnNumericData::kBoolean, 0);
+  numericAttr.setHidden(true);
+  numericAttr.setConnectable(false);
+  addAttribute(batchDeform);
+
   return MS::kSuccess;
 }
 
@@ -91,6 +102,9 @@ MStatus FabricSpliceMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, c
     }
   }
 
+  if(block.inputValue(batchDeform).asBool() && _spliceGraph.getDGPort("meshes").isValid())
+    return deformBatched(block, iter, multiIndex);
+
   if(transferInputValuesToSplice(block))
   {
 
@@ -130,8 +144,15 @@ MStatus FabricSpliceMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, c
     if(!rtMesh.isValid() || rtMesh.isNullObject())
       return MStatus::kSuccess;
 
+    // meshes deformed as a whole go through the float32 path, reading the
+    // raw points of the output mesh, other geometries through MPointArray.
+    MObject meshObj;
+    MDataHandle outputGeomHandle = getOutputGeomHandle(block, multiIndex);
+    bool useFloatPoints = dfgGetFullMesh(outputGeomHandle, iter, meshObj);
+
     MPointArray mayaPoints;
-    iter.allPositions(mayaPoints);
+    if(!useFloatPoints)
+      iter.allPositions(mayaPoints);
 
     // MPlug inputPlug(thisMObject(), input);
     // MPlug inputElementPlug = inputPlug.elementByPhysicalIndex(multiIndex);
@@ -154,51 +175,49 @@ MStatus FabricSpliceMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, c
     //   mayaNormals[i].z = mayaFnormals[mayaIndices[i]].z;
     // }
 
-    try
+    if(useFloatPoints)
     {
-      std::vector<FabricCore::RTVal> args(2);
-      args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
-      args[1] = FabricSplice::constructUInt32RTVal(4); // components
-      rtMesh.callMethod("", "setPointsFromExternalArray_d", 2, &args[0]);
-
-      // FabricCore::RTVal normalsVar = 
-      //   FabricSplice::constructExternalArrayRTVal("Float64", mayaNormals.length() * 3, &mayaNormals[0]);
-      // rtMesh.callMethod("", "setNormalsFromFloat64Array", 1, &normalsVar);
+      MFnMesh mesh(meshObj);
+      if(!dfgSetPolygonMeshPoints(rtMesh, mesh.getRawPoints(NULL), mesh.numVertices()))
+        return MStatus::kSuccess;
     }
-    catch(FabricCore::Exception e)
-    {
-      mayaLogErrorFunc(e.getDesc_cstr());
+    else if(!dfgSetPolygonMeshPoints(rtMesh, mayaPoints))
       return MStatus::kSuccess;
-    }
+
+    // FabricCore::RTVal normalsVar = 
+    //   FabricSplice::constructExternalArrayRTVal("Float64", mayaNormals.length() * 3, &mayaNormals[0]);
+    // rtMesh.callMethod("", "setNormalsFromFloat64Array", 1, &normalsVar);
+
     port.setRTVal( rtValToSet );
 
     evaluate();
 
-    try
+    if(useFloatPoints)
     {
-      std::vector<FabricCore::RTVal> args(2);
-      args[0] = FabricSplice::constructExternalArrayRTVal("Float64", mayaPoints.length() * 4, &mayaPoints[0]);
-      args[1] = FabricSplice::constructUInt32RTVal(4); // components
-      rtMesh.callMethod("", "getPointsAsExternalArray_d", 2, &args[0]);
-
-      // FabricCore::RTVal normalsVar = 
-      //     FabricSplice::constructExternalArrayRTVal("Float64", mayaNormals.length() * 3, &mayaNormals[0]);
-      // rtMesh.callMethod("", "getNormalsAsFloat64Array", 1, &normalsVar);
-
-      // for(unsigned int i=0;i<mayaIndices.length();i++)
-      // {
-      //   mayaFnormals[mayaIndices[i]].x = mayaNormals[i].x;
-      //   mayaFnormals[mayaIndices[i]].y = mayaNormals[i].y;
-      //   mayaFnormals[mayaIndices[i]].z = mayaNormals[i].z;
-      // }
+      MFnMesh mesh(meshObj);
+      MFloatPointArray mayaFloatPoints(mesh.numVertices());
+      if(!dfgGetPolygonMeshPoints(rtMesh, mayaFloatPoints))
+        return MStatus::kSuccess;
+      mesh.setPoints(mayaFloatPoints);
     }
-    catch(FabricCore::Exception e)
+    else
     {
-      mayaLogErrorFunc(e.getDesc_cstr());
-      return MStatus::kSuccess;
+      if(!dfgGetPolygonMeshPoints(rtMesh, mayaPoints))
+        return MStatus::kSuccess;
+      iter.setAllPositions(mayaPoints);
     }
 
-    iter.setAllPositions(mayaPoints);
+    // FabricCore::RTVal normalsVar = 
+    //     FabricSplice::constructExternalArrayRTVal("Float64", mayaNormals.length() * 3, &mayaNormals[0]);
+    // rtMesh.callMethod("", "getNormalsAsFloat64Array", 1, &normalsVar);
+
+    // for(unsigned int i=0;i<mayaIndices.length();i++)
+    // {
+    //   mayaFnormals[mayaIndices[i]].x = mayaNormals[i].x;
+    //   mayaFnormals[mayaIndices[i]].y = mayaNormals[i].y;
+    //   mayaFnormals[mayaIndices[i]].z = mayaNormals[i].z;
+    // }
+
     // mesh.setNormals(mayaFnormals);
     transferOutputValuesToMaya(block, true);
   }
@@ -208,9 +227,153 @@ MStatus FabricSpliceMayaDeformer::deform(MDataBlock& block, MItGeometry& iter, c
   return stat;
 }
 
+MStatus FabricSpliceMayaDeformer::deformBatched(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex){
+
+  FabricSplice::Logging::AutoTimer timer("Maya::deformBatched()");
+
+  // the graph has already been evaluated during this cycle,
+  // only copy this geometry's result back.
+  if(mBatchEvaluated && multiIndex < mBatchServed.size() && !mBatchServed[multiIndex])
+  {
+    mBatchServed[multiIndex] = true;
+    applyBatchPoints(block, iter, multiIndex);
+    return MStatus::kSuccess;
+  }
+
+  // a geometry asked twice starts a new cycle
+  mBatchEvaluated = false;
+
+  if(!transferInputValuesToSplice(block))
+    return MStatus::kSuccess;
+
+  FabricSplice::DGPort port = _spliceGraph.getDGPort("meshes");
+  if(!port.isValid())
+    return MStatus::kSuccess;
+  if(port.getMode() != FabricSplice::Port_Mode_IO)
+    return MStatus::kSuccess;
+
+  FabricCore::RTVal rtMeshes = port.getRTVal( FabricCore::LockType_Exclusive );
+  if(!rtMeshes.isValid())
+    return MStatus::kSuccess;
+  if(!rtMeshes.isArray())
+    return MStatus::kSuccess;
+
+  unsigned int nbMeshes = rtMeshes.getArraySize();
+  if(multiIndex >= nbMeshes)
+    return MStatus::kSuccess;
+
+  mBatchPoints.resize(nbMeshes);
+  mBatchFloatPoints.resize(nbMeshes);
+  mBatchServed.assign(nbMeshes, false);
+
+  // gather the points of every connected geometry
+  std::vector<FabricCore::RTVal> rtMeshVals(nbMeshes);
+  MArrayDataHandle inputArrayHandle = block.inputArrayValue(input);
+  for(unsigned int i = 0; i < nbMeshes; ++i)
+  {
+    mBatchPoints[i].clear();
+    mBatchFloatPoints[i].clear();
+
+    rtMeshVals[i] = rtMeshes.getArrayElement(i);
+    if(!rtMeshVals[i].isValid() || rtMeshVals[i].isNullObject())
+      continue;
+
+    MObject meshObj;
+    if(i == multiIndex)
+    {
+      MDataHandle outputGeomHandle = getOutputGeomHandle(block, i);
+      if(!dfgGetFullMesh(outputGeomHandle, iter, meshObj))
+        iter.allPositions(mBatchPoints[i]);
+    }
+    else
+    {
+      if(inputArrayHandle.jumpToElement(i) != MS::kSuccess)
+        continue;
+      MDataHandle inputElementHandle = inputArrayHandle.inputValue();
+      MDataHandle inputGeomHandle = inputElementHandle.child(inputGeom);
+      unsigned int inputGroupId = inputElementHandle.child(groupId).asInt();
+      MItGeometry inputIter(inputGeomHandle, inputGroupId, true /* readOnly */);
+      if(!dfgGetFullMesh(inputGeomHandle, inputIter, meshObj))
+        inputIter.allPositions(mBatchPoints[i]);
+    }
+
+    if(!meshObj.isNull())
+    {
+      MFnMesh mesh(meshObj);
+      mBatchFloatPoints[i].setLength(mesh.numVertices());
+      if(mBatchFloatPoints[i].length() == 0)
+        continue;
+      if(!dfgSetPolygonMeshPoints(rtMeshVals[i], mesh.getRawPoints(NULL), mesh.numVertices()))
+        mBatchFloatPoints[i].clear();
+      continue;
+    }
+
+    if(mBatchPoints[i].length() == 0)
+      continue;
+    if(!dfgSetPolygonMeshPoints(rtMeshVals[i], mBatchPoints[i]))
+      mBatchPoints[i].clear();
+  }
+  port.setRTVal( rtMeshes );
+
+  evaluate();
+
+  for(unsigned int i = 0; i < nbMeshes; ++i)
+  {
+    if(mBatchFloatPoints[i].length() > 0)
+    {
+      if(!dfgGetPolygonMeshPoints(rtMeshVals[i], mBatchFloatPoints[i]))
+        mBatchFloatPoints[i].clear();
+    }
+    else if(mBatchPoints[i].length() > 0)
+    {
+      if(!dfgGetPolygonMeshPoints(rtMeshVals[i], mBatchPoints[i]))
+        mBatchPoints[i].clear();
+    }
+  }
+
+  transferOutputValuesToMaya(block, true);
+
+  mBatchEvaluated = true;
+  mBatchServed[multiIndex] = true;
+  applyBatchPoints(block, iter, multiIndex);
+
+  return MStatus::kSuccess;
+}
+
+void FabricSpliceMayaDeformer::applyBatchPoints(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex)
+{
+  if(mBatchFloatPoints[multiIndex].length() > 0)
+  {
+    MObject meshObj;
+    MDataHandle outputGeomHandle = getOutputGeomHandle(block, multiIndex);
+    if(dfgGetFullMesh(outputGeomHandle, iter, meshObj))
+    {
+      MFnMesh mesh(meshObj);
+      if(mesh.numVertices() == (int)mBatchFloatPoints[multiIndex].length())
+      {
+        mesh.setPoints(mBatchFloatPoints[multiIndex]);
+        return;
+      }
+    }
+  }
+
+  if(mBatchPoints[multiIndex].length() > 0)
+    iter.setAllPositions(mBatchPoints[multiIndex]);
+}
+
+MDataHandle FabricSpliceMayaDeformer::getOutputGeomHandle(MDataBlock& block, unsigned int multiIndex)
+{
+  MArrayDataHandle outputArrayHandle = block.outputArrayValue(outputGeom);
+  if(outputArrayHandle.jumpToElement(multiIndex) != MS::kSuccess)
+    return MDataHandle();
+  return outputArrayHandle.outputValue();
+}
+
 MStatus FabricSpliceMayaDeformer::setDependentsDirty(MPlug const &inPlug, MPlugArray &affectedPlugs){
   MStatus stat = FabricSpliceBaseInterface::setDependentsDirty(thisMObject(), inPlug, affectedPlugs);
 
+  resetBatch();
+
   MFnDependencyNode thisNode(thisMObject());
   MPlug output = thisNode.findPlug("outputGeometry");
   affectedPlugs.append(output);
@@ -236,6 +399,7 @@ void FabricSpliceMayaDeformer::invalidateNode()
   }
 
   mGeometryInitialized = false;
+  resetBatch();
 }
 
 MStatus FabricSpliceMayaDeformer::shouldSave(const MPlug &plug, bool &isSaving){
@@ -290,6 +454,7 @@ MStatus FabricSpliceMayaDeformer::connectionBroken(const MPlug &plug, const MPlu
 #if MAYA_API_VERSION >= 201600
 MStatus FabricSpliceMayaDeformer::preEvaluation(const MDGContext& context, const MEvaluationNode& evaluationNode)
 {
+  resetBatch();
   return FabricSpliceBaseInterface::preEvaluation(thisMObject(), context, evaluationNode);
 }
 #endif
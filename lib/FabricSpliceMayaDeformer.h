@@ -9,6 +9,8 @@
 #include <maya/MPxDeformerNode.h>
 #include <maya/MTypeId.h>
 #include <maya/MItGeometry.h>
+#include <maya/MPointArray.h>
+#include <maya/MFloatPointArray.h>
 
 class FabricSpliceMayaDeformer: public MPxDeformerNode, public FabricSpliceBaseInterface{
 public:
@@ -41,6 +43,7 @@ public:
   static MTypeId id;
   static MObject saveData;
   static MObject evalID;
+  static MObject batchDeform;
 
 protected:
   virtual void invalidateNode();
@@ -51,4 +54,15 @@ private:
   int initializePolygonMeshPorts(MPlug &meshPlug, MDataBlock &data);
   // void initializeGeometry(MObject &meshObj);
   int mGeometryInitialized;
+
+  // batched deformation, see FabricDFGMayaDeformer
+  MStatus deformBatched(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex);
+  void applyBatchPoints(MDataBlock& block, MItGeometry& iter, unsigned int multiIndex);
+  void resetBatch() { mBatchEvaluated = false; }
+  bool mBatchEvaluated;
+  std::vector<MPointArray> mBatchPoints;
+  std::vector<MFloatPointArray> mBatchFloatPoints;
+  std::vector<bool> mBatchServed;
+
+  MDataHandle getOutputGeomHandle(MDataBlock& block, unsigned int multiIndex);
 };
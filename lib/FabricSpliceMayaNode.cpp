@@ -23,6 +23,7 @@ FabricSpliceMayaNode::FabricSpliceMayaNode()
 
 void FabricSpliceMayaNode::postConstructor()
 {
+  FabricSpliceBaseInterface::registerInstanceMObject();
   FabricSpliceBaseInterface::constructBaseInterface();
 
   MObject object = thisMObject();
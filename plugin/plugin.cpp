@@ -251,6 +251,11 @@ MAYA_EXPORT initializePlugin(MObject obj)
   if (!FabricDFGBaseInterface::s_use_evalContext)
     MGlobal::displayInfo("[Fabric for Maya]: evalContext has been disabled via the environment variable FABRIC_MAYA_DISABLE_EVALCONTEXT.");
 
+  char const *defer_restore = ::getenv( "FABRIC_MAYA_DEFER_GRAPH_RESTORE" );
+  FabricDFGBaseInterface::s_deferRestore = !!defer_restore && !!defer_restore[0];
+  if (FabricDFGBaseInterface::s_deferRestore)
+    MGlobal::displayInfo("[Fabric for Maya]: the Canvas graphs are restored on first use via the environment variable FABRIC_MAYA_DEFER_GRAPH_RESTORE.");
+
   MFnPlugin plugin(obj, "FabricMaya", FabricSplice::GetFabricVersionStr(), "Any");
   MStatus status = MStatus::kSuccess;
 